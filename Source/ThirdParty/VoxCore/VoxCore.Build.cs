@@ -0,0 +1,15 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+using System.IO;
+using UnrealBuildTool;
+
+public class VoxCore : ModuleRules
+{
+	public VoxCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		//header only library, also built standalone by CMakeLists.txt for benchmark
+		Type = ModuleType.External;
+
+		PublicIncludePaths.Add(Path.Combine(ModuleDirectory, "include"));
+	}
+}
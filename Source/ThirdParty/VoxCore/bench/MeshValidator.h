@@ -0,0 +1,229 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "VoxCore/MonotoneMesher.h"
+#include "VoxCore/NaiveMesher.h"
+
+namespace VoxCore
+{
+
+/**
+ * @struct MeshReport
+ * Result of mesh validation.
+ */
+struct MeshReport
+{
+	/** Triangles of validated mesh and naive oracle */
+	size_t Triangles = 0;
+	size_t NaiveTriangles = 0;
+	/** Vertices lying inside an edge of another triangle, allowed by design and not an error */
+	size_t TJunctions = 0;
+	/** First errors found, empty if valid */
+	std::vector<std::string> Errors;
+
+	bool IsValid() const { return Errors.empty(); }
+};
+
+/**
+ * MeshValidator
+ * Validate mesh of volume against naive mesher.
+ *  - Every triangle is axis aligned, not degenerate and winds toward its solid cell of its color
+ *  - Area of every plane, direction and color equals visible cell faces
+ *  - Every edge is matched by opposite edges along the same line, so no cracks even across T-junctions
+ * Merged polygons meet neighbours inside their edges, so T-junctions are
+ * counted but do not fail validation.
+ */
+class MeshValidator
+{
+public:
+
+	MeshValidator(const VoxVolume& InVolume, const MeshOptions& InOptions = MeshOptions())
+		: Volume(InVolume), Options(InOptions)
+	{
+	}
+
+	MeshReport Validate(const VoxMesh& Mesh) const
+	{
+		MeshReport Report;
+		VoxMesh Naive;
+		NaiveMesher(Volume, Options).CreateMesh(Naive);
+		Report.Triangles = Mesh.GetNumTriangles();
+		Report.NaiveTriangles = Naive.GetNumTriangles();
+
+		AreaMap Area, NaiveArea;
+		CheckTriangles(Naive, NaiveArea, "naive", Report);
+		CheckTriangles(Mesh, Area, "mesh", Report);
+		CheckClosed(Mesh, Report);
+		if (Area != NaiveArea) {
+			for (const auto& Entry : NaiveArea) {
+				const auto Found = Area.find(Entry.first);
+				const int64_t Actual = Found != Area.end() ? Found->second : 0;
+				if (Actual != Entry.second) {
+					AddError(Report, "area of direction %d plane %d color %d is %lld, expected %lld",
+						(int)(Entry.first >> 24), (int)((Entry.first >> 8) & 0xffff), (int)(Entry.first & 0xff), (long long)Actual / 2, (long long)Entry.second / 2);
+				}
+			}
+			for (const auto& Entry : Area) {
+				if (NaiveArea.find(Entry.first) == NaiveArea.end()) {
+					AddError(Report, "area of direction %d plane %d color %d is not visible",
+						(int)(Entry.first >> 24), (int)((Entry.first >> 8) & 0xffff), (int)(Entry.first & 0xff));
+				}
+			}
+		}
+		if (Report.NaiveTriangles < Report.Triangles) {
+			AddError(Report, "%zu triangles, more than %zu of naive mesh", Report.Triangles, Report.NaiveTriangles);
+		}
+		return Report;
+	}
+
+private:
+
+	/** Doubled area by direction, plane and color */
+	typedef std::map<uint32_t, int64_t> AreaMap;
+
+	static const size_t MaxErrors = 8;
+
+	template<typename... Args>
+	static void AddError(MeshReport& Report, const char* Format, Args... Arguments)
+	{
+		if (MaxErrors <= Report.Errors.size()) return;
+		char Buffer[256];
+		std::snprintf(Buffer, sizeof(Buffer), Format, Arguments...);
+		Report.Errors.push_back(Buffer);
+	}
+
+	static uint64_t PackPosition(const Int3& Position)
+	{
+		return (uint64_t)(uint32_t)(Position.X + 1) | ((uint64_t)(uint32_t)(Position.Y + 1) << 21) | ((uint64_t)(uint32_t)(Position.Z + 1) << 42);
+	}
+
+	/**
+	 * Point strictly inside of triangle off every cell boundary, scaled by Denominator
+	 * Weights near to centroid are tried until the point leaves cell boundaries.
+	 */
+	static bool GetInnerCell(const Int3 (&Vertex)[3], int Axis, Int3& OutCell)
+	{
+		static const int64_t Denominator = 1000003;
+		static const int64_t Weights[4][2] = { { 333337, 333331 }, { 333347, 333323 }, { 333359, 333313 }, { 333367, 333301 } };
+		for (const auto& Weight : Weights) {
+			const int64_t W[3] = { Weight[0], Weight[1], Denominator - Weight[0] - Weight[1] };
+			bool bBoundary = false;
+			for (int Component = 0; Component < 3; ++Component) {
+				if (Component == Axis) {
+					OutCell[Component] = Vertex[0][Component];
+					continue;
+				}
+				const int64_t Scaled = W[0] * Vertex[0][Component] + W[1] * Vertex[1][Component] + W[2] * Vertex[2][Component];
+				bBoundary |= Scaled % Denominator == 0;
+				OutCell[Component] = (int32_t)(Scaled / Denominator);
+			}
+			if (!bBoundary) return true;
+		}
+		return false;
+	}
+
+	void CheckTriangles(const VoxMesh& Mesh, AreaMap& OutArea, const char* Name, MeshReport& Report) const
+	{
+		if (Mesh.Colors.size() != Mesh.GetNumTriangles() || Mesh.Materials.size() != Mesh.GetNumTriangles()
+			|| (Options.bAmbientOcclusion && Mesh.WedgeAO.size() != Mesh.Indices.size())) {
+			AddError(Report, "%s: attribute count does not match triangles", Name);
+			return;
+		}
+		for (size_t Triangle = 0; Triangle < Mesh.GetNumTriangles(); ++Triangle) {
+			Int3 Vertex[3];
+			for (int Wedge = 0; Wedge < 3; ++Wedge) {
+				const uint32_t Index = Mesh.Indices[Triangle * 3 + Wedge];
+				if (Mesh.Positions.size() <= Index) {
+					AddError(Report, "%s: triangle %zu index out of range", Name, Triangle);
+					return;
+				}
+				Vertex[Wedge] = Mesh.Positions[Index];
+			}
+			const Int3 e1 = Vertex[1] - Vertex[0], e2 = Vertex[2] - Vertex[0];
+			const int64_t Cross[3] = {
+				(int64_t)e1.Y * e2.Z - (int64_t)e1.Z * e2.Y,
+				(int64_t)e1.Z * e2.X - (int64_t)e1.X * e2.Z,
+				(int64_t)e1.X * e2.Y - (int64_t)e1.Y * e2.X,
+			};
+			const int NonZero = (Cross[0] != 0) + (Cross[1] != 0) + (Cross[2] != 0);
+			if (NonZero != 1) {
+				AddError(Report, "%s: triangle %zu is %s", Name, Triangle, NonZero == 0 ? "degenerate" : "not axis aligned");
+				continue;
+			}
+			//face winds clockwise seen from outside, geometric normal points into solid cell
+			const int Axis = Cross[0] != 0 ? 0 : Cross[1] != 0 ? 1 : 2;
+			const bool bPositive = Cross[Axis] < 0;
+			const int Direction = (Axis == 2 ? 0 : Axis == 0 ? 2 : 4) + (bPositive ? 0 : 1);
+			const uint8_t Color = Mesh.Colors[Triangle];
+			Int3 Solid;
+			if (!GetInnerCell(Vertex, Axis, Solid)) {
+				AddError(Report, "%s: triangle %zu has no inner point", Name, Triangle);
+				continue;
+			}
+			Int3 Empty = Solid;
+			bPositive ? --Solid[Axis] : --Empty[Axis];
+			if (Volume.Get(Solid) != Color + 1 || Volume.IsSolid(Empty)) {
+				AddError(Report, "%s: triangle %zu of color %d faces from (%d, %d, %d) toward (%d, %d, %d), wrong winding, color or hidden face",
+					Name, Triangle, (int)Color, Solid.X, Solid.Y, Solid.Z, Empty.X, Empty.Y, Empty.Z);
+			}
+			if (Mesh.Materials[Triangle] != (Options.bGroupByDirection ? Direction : 0)) {
+				AddError(Report, "%s: triangle %zu of direction %d has material %d", Name, Triangle, Direction, (int)Mesh.Materials[Triangle]);
+			}
+			const uint32_t Key = ((uint32_t)Direction << 24) | ((uint32_t)(Vertex[0][Axis] & 0xffff) << 8) | Color;
+			OutArea[Key] += std::llabs(Cross[Axis]);
+		}
+	}
+
+	/** Count directed edges split at every lattice point, each must be matched by reverse edges */
+	void CheckClosed(const VoxMesh& Mesh, MeshReport& Report) const
+	{
+		struct PairHash
+		{
+			size_t operator()(const std::pair<uint64_t, uint64_t>& Pair) const { return std::hash<uint64_t>()(Pair.first * 0x9E3779B97F4A7C15ull ^ Pair.second); }
+		};
+		std::unordered_map<std::pair<uint64_t, uint64_t>, int32_t, PairHash> Edges;
+		std::unordered_set<uint64_t> Positions;
+		for (const Int3& Position : Mesh.Positions) {
+			Positions.insert(PackPosition(Position));
+		}
+		for (size_t Wedge = 0; Wedge < Mesh.Indices.size(); ++Wedge) {
+			const size_t Next = Wedge % 3 == 2 ? Wedge - 2 : Wedge + 1;
+			if (Mesh.Positions.size() <= Mesh.Indices[Wedge] || Mesh.Positions.size() <= Mesh.Indices[Next]) return;
+			const Int3 From = Mesh.Positions[Mesh.Indices[Wedge]];
+			const Int3 To = Mesh.Positions[Mesh.Indices[Next]];
+			const Int3 Delta = To - From;
+			const int32_t Length = std::gcd(std::gcd(std::abs(Delta.X), std::abs(Delta.Y)), std::abs(Delta.Z));
+			if (Length == 0) continue;
+			const Int3 Step(Delta.X / Length, Delta.Y / Length, Delta.Z / Length);
+			for (Int3 Point = From; Point != To; Point = Point + Step) {
+				const Int3 PointNext = Point + Step;
+				if (Point != From && Positions.count(PackPosition(Point))) {
+					++Report.TJunctions;
+				}
+				++Edges[std::make_pair(PackPosition(Point), PackPosition(PointNext))];
+				--Edges[std::make_pair(PackPosition(PointNext), PackPosition(Point))];
+			}
+		}
+		for (const auto& Edge : Edges) {
+			if (Edge.second != 0 && Edge.first.first < Edge.first.second) {
+				AddError(Report, "crack at edge %llx to %llx, %d unmatched", (unsigned long long)Edge.first.first, (unsigned long long)Edge.first.second, (int)Edge.second);
+			}
+		}
+	}
+
+private:
+
+	const VoxVolume& Volume;
+	MeshOptions Options;
+};
+
+} // namespace VoxCore
@@ -0,0 +1,162 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+/**
+ * VisibilityBench
+ * Single thread throughput of visible face kernel per instruction set.
+ *   VisibilityBench [--size N] [--fill F] [--iterations N]
+ * Slices of N x N cells are filled at random with ratio F. Every variant is
+ * checked against scalar before timing, fastest of N runs is reported.
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "VoxCore/VisibilityKernel.h"
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	struct Slices
+	{
+		std::vector<uint8_t> Back, Front, BackOccluded, FrontOccluded, Color, Flipped;
+		size_t Count = 0;
+	};
+
+	typedef void (*KernelFunc)(const Slices& In, uint8_t* OutColor, uint8_t* OutFlipped);
+
+	void Scalar(const Slices& In, uint8_t* OutColor, uint8_t* OutFlipped)
+	{
+		VoxCore::VisibilityKernel::ComputeScalar(In.Back.data(), In.Front.data(), In.BackOccluded.data(), In.FrontOccluded.data(), OutColor, OutFlipped, 0, In.Count);
+	}
+
+#if VOXCORE_SSE2
+	void Sse2(const Slices& In, uint8_t* OutColor, uint8_t* OutFlipped)
+	{
+		const size_t Index = VoxCore::VisibilityKernel::ComputeSse2(In.Back.data(), In.Front.data(), In.BackOccluded.data(), In.FrontOccluded.data(), OutColor, OutFlipped, In.Count);
+		VoxCore::VisibilityKernel::ComputeScalar(In.Back.data(), In.Front.data(), In.BackOccluded.data(), In.FrontOccluded.data(), OutColor, OutFlipped, Index, In.Count);
+	}
+#endif
+
+#if VOXCORE_AVX2
+	void Avx2(const Slices& In, uint8_t* OutColor, uint8_t* OutFlipped)
+	{
+		const size_t Index = VoxCore::VisibilityKernel::ComputeAvx2(In.Back.data(), In.Front.data(), In.BackOccluded.data(), In.FrontOccluded.data(), OutColor, OutFlipped, In.Count);
+		VoxCore::VisibilityKernel::ComputeScalar(In.Back.data(), In.Front.data(), In.BackOccluded.data(), In.FrontOccluded.data(), OutColor, OutFlipped, Index, In.Count);
+	}
+#endif
+
+	void FillSlices(size_t Size, double Fill, Slices& Out)
+	{
+		std::mt19937 Random(1);
+		std::uniform_real_distribution<double> Unit(0.0, 1.0);
+		Out.Count = Size * Size;
+		for (auto* Slice : { &Out.Back, &Out.Front, &Out.BackOccluded, &Out.FrontOccluded }) {
+			Slice->resize(Out.Count + VoxCore::VisibilityKernel::Padding);
+		}
+		for (size_t i = 0; i < Out.Count; ++i) {
+			Out.Back[i] = Unit(Random) < Fill ? (uint8_t)(1 + Random() % 255) : 0;
+			Out.Front[i] = Unit(Random) < Fill ? (uint8_t)(1 + Random() % 255) : 0;
+			Out.BackOccluded[i] = !Out.Back[i] && Unit(Random) < 0.1 ? 1 : 0;
+			Out.FrontOccluded[i] = !Out.Front[i] && Unit(Random) < 0.1 ? 1 : 0;
+		}
+		Out.Color.assign(Out.Count + VoxCore::VisibilityKernel::Padding, 0);
+		Out.Flipped.assign(Out.Count + VoxCore::VisibilityKernel::Padding, 0);
+	}
+
+	template<typename Func>
+	double Time(int Iterations, Func&& Run)
+	{
+		double Best = 1e30;
+		for (int i = 0; i < Iterations; ++i) {
+			const auto Start = Clock::now();
+			Run();
+			Best = std::min(Best, std::chrono::duration<double>(Clock::now() - Start).count());
+		}
+		return Best;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t Size = 256;
+	double Fill = 0.5;
+	int Iterations = 20;
+	for (int i = 1; i < argc; ++i) {
+		const std::string Arg = argv[i];
+		if (Arg == "--size" && i + 1 < argc) {
+			Size = (size_t)std::max(1, std::atoi(argv[++i]));
+		} else if (Arg == "--fill" && i + 1 < argc) {
+			Fill = std::atof(argv[++i]);
+		} else if (Arg == "--iterations" && i + 1 < argc) {
+			Iterations = std::max(1, std::atoi(argv[++i]));
+		} else {
+			std::fprintf(stderr, "usage: VisibilityBench [--size N] [--fill F] [--iterations N]\n");
+			return 2;
+		}
+	}
+
+	Slices In;
+	FillSlices(Size, Fill, In);
+	std::vector<uint8_t> ExpectedColor(In.Color.size()), ExpectedFlipped(In.Flipped.size());
+	Scalar(In, ExpectedColor.data(), ExpectedFlipped.data());
+
+	struct Variant { const char* Name; KernelFunc Func; };
+	const Variant Variants[] = {
+		{ "scalar", Scalar },
+#if VOXCORE_SSE2
+		{ "sse2", Sse2 },
+#endif
+#if VOXCORE_AVX2
+		{ "avx2", Avx2 },
+#endif
+	};
+
+	// Slices are run many times per sample, a single 256 x 256 slice is too short to time
+	const int Repeat = (int)std::max<size_t>(1, (1 << 24) / In.Count);
+	const double Cells = (double)In.Count * Repeat;
+	std::printf("%zu x %zu cells, fill %.2f, one thread\n", Size, Size, Fill);
+	std::printf("%-12s %12s %12s %10s\n", "kernel", "Mcells/s", "input GB/s", "speedup");
+	double ScalarSeconds = 0.0;
+	int Failures = 0;
+	for (const Variant& Kernel : Variants) {
+		std::fill(In.Color.begin(), In.Color.end(), 0);
+		std::fill(In.Flipped.begin(), In.Flipped.end(), 0);
+		Kernel.Func(In, In.Color.data(), In.Flipped.data());
+		if (In.Color != ExpectedColor || In.Flipped != ExpectedFlipped) {
+			std::printf("%-12s differs from scalar\n", Kernel.Name);
+			++Failures;
+			continue;
+		}
+		const double Seconds = Time(Iterations, [&]() {
+			for (int r = 0; r < Repeat; ++r) Kernel.Func(In, In.Color.data(), In.Flipped.data());
+		});
+		if (ScalarSeconds == 0.0) ScalarSeconds = Seconds;
+		std::printf("%-12s %12.1f %12.2f %9.2fx\n", Kernel.Name, Cells / Seconds / 1e6, Cells * 4 / Seconds / 1e9, ScalarSeconds / Seconds);
+	}
+
+	//run starts of every row, kernel output of last variant has padding cells around
+	const size_t Count = Size - 2;
+	std::vector<uint64_t> Bits(Count / 64 + 1);
+	uint64_t Runs = 0;
+	const double RunSeconds = Time(Iterations, [&]() {
+		for (int r = 0; r < Repeat; ++r) {
+			for (size_t Row = 1; Row + 1 < Size; ++Row) {
+				uint8_t* Color = In.Color.data() + Row * Size + 1;
+				uint8_t* Flipped = In.Flipped.data() + Row * Size + 1;
+				Color[-1] = Color[Count] = Flipped[-1] = Flipped[Count] = 0;
+				VoxCore::VisibilityKernel::FindRunStarts(Color, Flipped, Count, Bits.data());
+				for (uint64_t Word : Bits) Runs += std::bitset<64>(Word).count();
+			}
+		}
+	});
+	std::printf("%-12s %12.1f %12s %10s\n", "run starts", (double)Count * (Size - 2) * Repeat / RunSeconds / 1e6, "", "");
+	std::printf("%llu run starts counted\n", (unsigned long long)Runs);
+	return Failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,621 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+/**
+ * VoxBench
+ * Time VoxCore parse and mesh over a corpus of vox files without the editor.
+ *   VoxBench [--iterations N] [--ao] [--group] [--csv FILE] [--label TEXT] PATH...
+ *   VoxBench --sweep [--sweep-shapes LIST] [--sweep-sizes LIST] [--sweep-fills LIST]
+ *            [--sweep-colors LIST] [--sweep-models LIST] [--sweep-depths LIST] ...
+ *   VoxBench ... [--check] [--baseline CSV] [--max-time-regression R] [--max-triangle-regression R]
+ *   VoxBench ... [--order file|morton|shuffle]
+ *   VoxBench ... [--lightmap]
+ * Directories are searched recursively for .vox files. Sweep generates every
+ * combination of comma separated parameter lists in memory instead. Every
+ * stage is run N times and the fastest run is reported, CSV rows are appended
+ * to track throughput per commit. Check validates every mesh against naive
+ * mesher, baseline fails cases slower or with more triangles than the last
+ * row of the same case in a previous CSV. Order sorts cells in Z order as
+ * part of parse like the editor, or shuffles them to time cell passes on
+ * scattered input. Lightmap packs charts of every mesh and reports packing
+ * time and texels covered by charts. Exit code is 1 on any failure.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+#include "VoxCore/VoxCore.h"
+#include "MeshValidator.h"
+#include "VoxGenerator.h"
+
+namespace
+{
+	struct SweepOptions
+	{
+		std::vector<std::string> Shapes = { "noise", "terrain", "shell", "solid" };
+		std::vector<int32_t> Sizes = { 16, 32, 64, 128 };
+		std::vector<float> Fills = { 0.5f };
+		std::vector<int32_t> Colors = { 16 };
+		std::vector<int32_t> Models = { 1 };
+		std::vector<int32_t> Depths = { 0 };
+	};
+
+	struct BenchOptions
+	{
+		int Iterations = 5;
+		VoxCore::MeshOptions Mesh;
+		std::string Csv;
+		std::string Label;
+		std::vector<std::string> Paths;
+		bool bSweep = false;
+		SweepOptions Sweep;
+		/** Order of cells after parse, file, morton or shuffle */
+		std::string Order = "file";
+		/** Validate meshes against naive mesher */
+		bool bCheck = false;
+		/** Pack lightmap charts of every mesh */
+		bool bLightmap = false;
+		std::string Baseline;
+		/** Allowed ratio of mesh time and triangles over baseline */
+		double MaxTimeRegression = 0.25;
+		double MaxTriangleRegression = 0.0;
+		/** Mesh time under this is timer noise, never a regression */
+		double MinTimeMilliseconds = 1.0;
+	};
+
+	struct BenchResult
+	{
+		std::string Name;
+		size_t Bytes = 0;
+		size_t Models = 0;
+		size_t Cells = 0;
+		size_t Vertices = 0;
+		size_t Triangles = 0;
+		/** Cells with an open face, instances added by voxel component hiding unbeheld cells */
+		size_t Instances = 0;
+		double ParseSeconds = 0.0;
+		double VolumeSeconds = 0.0;
+		double MeshSeconds = 0.0;
+		double InstanceSeconds = 0.0;
+		/** Largest memory of parsed file, volume and mesh of one model */
+		size_t MemoryBytes = 0;
+		/** Triangles of naive mesh and T-junctions if checked */
+		size_t NaiveTriangles = 0;
+		size_t TJunctions = 0;
+		/** Lightmap charts and texels of packed models, models whose charts do not fit */
+		size_t Charts = 0;
+		double LightmapSeconds = 0.0;
+		double LightmapTexels = 0.0;
+		double ChartTexels = 0.0;
+		size_t Unpacked = 0;
+		std::vector<std::string> Errors;
+	};
+
+	struct BaselineResult
+	{
+		size_t Triangles = 0;
+		double MeshMilliseconds = 0.0;
+	};
+
+	typedef std::chrono::steady_clock Clock;
+
+	double Seconds(Clock::time_point Start)
+	{
+		return std::chrono::duration<double>(Clock::now() - Start).count();
+	}
+
+	/** Peak resident set size of process in megabytes, 0 if unknown */
+	double PeakMemory()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		struct rusage Usage;
+		getrusage(RUSAGE_SELF, &Usage);
+#if defined(__APPLE__)
+		return Usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+		return Usage.ru_maxrss / 1024.0;
+#endif
+#else
+		return 0.0;
+#endif
+	}
+
+	template<typename T>
+	size_t GetAllocatedSize(const std::vector<T>& Vector)
+	{
+		return Vector.capacity() * sizeof(T);
+	}
+
+	size_t GetAllocatedSize(const VoxCore::VoxFile& File)
+	{
+		size_t Result = GetAllocatedSize(File.Models) + GetAllocatedSize(File.Palette);
+		for (const VoxCore::VoxModel& Model : File.Models) {
+			Result += GetAllocatedSize(Model.Cells);
+		}
+		return Result;
+	}
+
+	size_t GetAllocatedSize(const VoxCore::VoxMesh& Mesh)
+	{
+		return GetAllocatedSize(Mesh.Positions) + GetAllocatedSize(Mesh.Indices) + GetAllocatedSize(Mesh.Colors)
+			+ GetAllocatedSize(Mesh.Materials) + GetAllocatedSize(Mesh.WedgeAO) + GetAllocatedSize(Mesh.Charts) + GetAllocatedSize(Mesh.TriangleCharts);
+	}
+
+	size_t GetAllocatedSize(const VoxCore::VoxVolume& Volume)
+	{
+		const VoxCore::Int3& Size = Volume.GetSize();
+		return (size_t)(Size.X + 2) * (Size.Y + 2) * (Size.Z + 2) * 2;
+	}
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"usage: VoxBench [--iterations N] [--ao] [--group] [--csv FILE] [--label TEXT] PATH...\n"
+			"       VoxBench --sweep [--sweep-shapes noise,terrain,shell,solid] [--sweep-sizes 16,32,...] [--sweep-fills 0.5,...]\n"
+			"                [--sweep-colors 16,...] [--sweep-models 1,...] [--sweep-depths 0,...] [--iterations N] [--csv FILE] [--label TEXT]\n"
+			"       VoxBench ... [--check] [--baseline CSV] [--max-time-regression 0.25] [--max-triangle-regression 0] [--min-time-ms 1]\n"
+			"       VoxBench ... [--order file|morton|shuffle]\n"
+			"       VoxBench ... [--lightmap]\n");
+	}
+
+	template<typename T, typename ParseFunc>
+	std::vector<T> ParseList(const char* Text, ParseFunc&& Parse)
+	{
+		std::vector<T> Result;
+		std::stringstream Stream(Text);
+		std::string Item;
+		while (std::getline(Stream, Item, ',')) {
+			if (!Item.empty()) Result.push_back(Parse(Item));
+		}
+		return Result;
+	}
+
+	std::vector<int32_t> ParseInts(const char* Text)
+	{
+		return ParseList<int32_t>(Text, [](const std::string& Item) { return std::atoi(Item.c_str()); });
+	}
+
+	bool ParseArguments(int argc, char** argv, BenchOptions& Out)
+	{
+		for (int i = 1; i < argc; ++i) {
+			const std::string Arg = argv[i];
+			const bool bValue = i + 1 < argc;
+			if (Arg == "--iterations" && bValue) {
+				Out.Iterations = std::max(1, std::atoi(argv[++i]));
+			} else if (Arg == "--ao") {
+				Out.Mesh.bAmbientOcclusion = true;
+			} else if (Arg == "--group") {
+				Out.Mesh.bGroupByDirection = true;
+			} else if (Arg == "--csv" && bValue) {
+				Out.Csv = argv[++i];
+			} else if (Arg == "--label" && bValue) {
+				Out.Label = argv[++i];
+			} else if (Arg == "--sweep") {
+				Out.bSweep = true;
+			} else if (Arg == "--sweep-shapes" && bValue) {
+				Out.Sweep.Shapes = ParseList<std::string>(argv[++i], [](const std::string& Item) { return Item; });
+			} else if (Arg == "--sweep-sizes" && bValue) {
+				Out.Sweep.Sizes = ParseInts(argv[++i]);
+			} else if (Arg == "--sweep-fills" && bValue) {
+				Out.Sweep.Fills = ParseList<float>(argv[++i], [](const std::string& Item) { return (float)std::atof(Item.c_str()); });
+			} else if (Arg == "--sweep-colors" && bValue) {
+				Out.Sweep.Colors = ParseInts(argv[++i]);
+			} else if (Arg == "--sweep-models" && bValue) {
+				Out.Sweep.Models = ParseInts(argv[++i]);
+			} else if (Arg == "--sweep-depths" && bValue) {
+				Out.Sweep.Depths = ParseInts(argv[++i]);
+			} else if (Arg == "--lightmap") {
+				Out.bLightmap = true;
+				Out.Mesh.bLightmapCharts = true;
+			} else if (Arg == "--check") {
+				Out.bCheck = true;
+			} else if (Arg == "--baseline" && bValue) {
+				Out.Baseline = argv[++i];
+			} else if (Arg == "--max-time-regression" && bValue) {
+				Out.MaxTimeRegression = std::atof(argv[++i]);
+			} else if (Arg == "--max-triangle-regression" && bValue) {
+				Out.MaxTriangleRegression = std::atof(argv[++i]);
+			} else if (Arg == "--min-time-ms" && bValue) {
+				Out.MinTimeMilliseconds = std::atof(argv[++i]);
+			} else if (Arg == "--order" && bValue) {
+				Out.Order = argv[++i];
+				if (Out.Order != "file" && Out.Order != "morton" && Out.Order != "shuffle") return false;
+			} else if (Arg.size() > 1 && Arg[0] == '-') {
+				return false;
+			} else {
+				Out.Paths.push_back(Arg);
+			}
+		}
+		return Out.bSweep || !Out.Paths.empty();
+	}
+
+	void CollectFiles(const std::vector<std::string>& Paths, std::vector<std::filesystem::path>& OutFiles)
+	{
+		namespace fs = std::filesystem;
+		for (const std::string& Path : Paths) {
+			std::error_code Error;
+			if (fs::is_directory(Path, Error)) {
+				for (const auto& Entry : fs::recursive_directory_iterator(Path, Error)) {
+					if (Entry.is_regular_file() && Entry.path().extension() == ".vox") {
+						OutFiles.push_back(Entry.path());
+					}
+				}
+			} else {
+				OutFiles.push_back(Path);
+			}
+		}
+		std::sort(OutFiles.begin(), OutFiles.end());
+	}
+
+	bool ReadFile(const std::filesystem::path& Path, std::vector<uint8_t>& OutData)
+	{
+		std::ifstream Stream(Path, std::ios::binary);
+		if (!Stream) return false;
+		OutData.assign(std::istreambuf_iterator<char>(Stream), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	/** Fill dense volume of model, cells outside of size are dropped */
+	void BuildVolume(const VoxCore::VoxModel& Model, VoxCore::VoxVolume& OutVolume)
+	{
+		for (const VoxCore::VoxCell& Cell : Model.Cells) {
+			if (Cell.X < Model.Size.X && Cell.Y < Model.Size.Y && Cell.Z < Model.Size.Z) {
+				OutVolume.Set(VoxCore::Int3(Cell.X, Cell.Y, Cell.Z), Cell.I);
+			}
+		}
+	}
+
+	/** Count cells with an empty neighbour like voxel component adding instances */
+	size_t CountInstances(const VoxCore::VoxModel& Model, const VoxCore::VoxVolume& Volume)
+	{
+		static const VoxCore::Int3 Neighbours[6] = {
+			VoxCore::Int3(0, 0, 1), VoxCore::Int3(0, 0, -1), VoxCore::Int3(1, 0, 0),
+			VoxCore::Int3(-1, 0, 0), VoxCore::Int3(0, 1, 0), VoxCore::Int3(0, -1, 0),
+		};
+		size_t Result = 0;
+		for (const VoxCore::VoxCell& Cell : Model.Cells) {
+			const VoxCore::Int3 Position(Cell.X, Cell.Y, Cell.Z);
+			for (const VoxCore::Int3& Neighbour : Neighbours) {
+				if (!Volume.IsSolid(Position + Neighbour)) {
+					++Result;
+					break;
+				}
+			}
+		}
+		return Result;
+	}
+
+	bool Bench(const std::string& Name, const std::vector<uint8_t>& Data, const BenchOptions& Options, BenchResult& Out)
+	{
+		Out.Name = Name;
+		Out.Bytes = Data.size();
+
+		VoxCore::VoxFile File;
+		Out.ParseSeconds = 1e30;
+		for (int i = 0; i < Options.Iterations; ++i) {
+			VoxCore::VoxFile Parsed;
+			const auto Start = Clock::now();
+			const VoxCore::VoxError Error = VoxCore::VoxReader(Data.data(), Data.size()).Read(Parsed);
+			if (Error == VoxCore::VoxError::None && Options.Order == "morton") {
+				VoxCore::Morton::Sort(Parsed);
+			}
+			Out.ParseSeconds = std::min(Out.ParseSeconds, Seconds(Start));
+			if (Error != VoxCore::VoxError::None) {
+				std::fprintf(stderr, "%s: not a valid vox file (%d)\n", Name.c_str(), (int)Error);
+				return false;
+			}
+			File = std::move(Parsed);
+		}
+		if (Options.Order == "shuffle") {
+			std::mt19937 Random(1);
+			for (VoxCore::VoxModel& Model : File.Models) {
+				std::shuffle(Model.Cells.begin(), Model.Cells.end(), Random);
+			}
+		}
+		Out.Models = File.Models.size();
+		Out.Cells = File.GetNumCells();
+		const size_t FileBytes = GetAllocatedSize(File);
+
+		for (const VoxCore::VoxModel& Model : File.Models) {
+			double VolumeSeconds = 1e30, MeshSeconds = 1e30, InstanceSeconds = 1e30;
+			VoxCore::VoxMesh Mesh;
+			size_t Instances = 0, VolumeBytes = 0;
+			for (int i = 0; i < Options.Iterations; ++i) {
+				auto Start = Clock::now();
+				VoxCore::VoxVolume Volume(Model.Size);
+				BuildVolume(Model, Volume);
+				VolumeSeconds = std::min(VolumeSeconds, Seconds(Start));
+				VolumeBytes = GetAllocatedSize(Volume);
+
+				VoxCore::VoxMesh Result;
+				Start = Clock::now();
+				VoxCore::MonotoneMesher(Volume, Options.Mesh).CreateMesh(Result);
+				MeshSeconds = std::min(MeshSeconds, Seconds(Start));
+				Mesh = std::move(Result);
+
+				Start = Clock::now();
+				Instances = CountInstances(Model, Volume);
+				InstanceSeconds = std::min(InstanceSeconds, Seconds(Start));
+			}
+			Out.VolumeSeconds += VolumeSeconds;
+			Out.MeshSeconds += MeshSeconds;
+			Out.InstanceSeconds += InstanceSeconds;
+			Out.Vertices += Mesh.Positions.size();
+			Out.Triangles += Mesh.GetNumTriangles();
+			Out.Instances += Instances;
+			Out.MemoryBytes = std::max(Out.MemoryBytes, FileBytes + VolumeBytes + GetAllocatedSize(Mesh));
+
+			if (Options.bLightmap) {
+				double LightmapSeconds = 1e30;
+				VoxCore::LightmapLayout Layout;
+				bool bPacked = false;
+				std::vector<float> UVs;
+				for (int i = 0; i < Options.Iterations; ++i) {
+					const auto Start = Clock::now();
+					const VoxCore::LightmapPacker Packer;
+					bPacked = Packer.Pack(Mesh, Layout);
+					if (bPacked) {
+						Packer.GetWedgeUVs(Mesh, Layout, UVs);
+					}
+					LightmapSeconds = std::min(LightmapSeconds, Seconds(Start));
+				}
+				Out.Charts += Mesh.Charts.size();
+				Out.LightmapSeconds += LightmapSeconds;
+				if (bPacked) {
+					const double Texels = (double)Layout.Resolution * Layout.Resolution;
+					Out.LightmapTexels += Texels;
+					Out.ChartTexels += Texels * Layout.Coverage;
+				} else {
+					++Out.Unpacked;
+				}
+			}
+
+			if (Options.bCheck) {
+				VoxCore::VoxVolume Volume(Model.Size);
+				BuildVolume(Model, Volume);
+				const VoxCore::MeshReport Report = VoxCore::MeshValidator(Volume, Options.Mesh).Validate(Mesh);
+				Out.NaiveTriangles += Report.NaiveTriangles;
+				Out.TJunctions += Report.TJunctions;
+				for (const std::string& Error : Report.Errors) {
+					Out.Errors.push_back("model " + std::to_string(&Model - File.Models.data()) + ": " + Error);
+				}
+			}
+		}
+		return true;
+	}
+
+	/** Last row of every case in CSV written by previous run */
+	bool ReadBaseline(const std::string& Path, std::map<std::string, BaselineResult>& OutBaseline)
+	{
+		std::ifstream Stream(Path);
+		std::string Line;
+		if (!Stream || !std::getline(Stream, Line)) return false;
+		std::vector<std::string> Columns = ParseList<std::string>(Line.c_str(), [](const std::string& Item) { return Item; });
+		const auto Column = [&](const char* Name) { return std::find(Columns.begin(), Columns.end(), Name) - Columns.begin(); };
+		const auto Case = Column("case"), Triangles = Column("triangles"), Mesh = Column("mesh_ms");
+		const ptrdiff_t NumColumns = (ptrdiff_t)Columns.size();
+		if (Case == NumColumns || Triangles == NumColumns || Mesh == NumColumns) return false;
+		while (std::getline(Stream, Line)) {
+			const std::vector<std::string> Values = ParseList<std::string>(Line.c_str(), [](const std::string& Item) { return Item; });
+			if ((ptrdiff_t)Values.size() < NumColumns) continue;
+			BaselineResult& Result = OutBaseline[Values[Case]];
+			Result.Triangles = (size_t)std::strtoull(Values[Triangles].c_str(), nullptr, 10);
+			Result.MeshMilliseconds = std::atof(Values[Mesh].c_str());
+		}
+		return true;
+	}
+
+	/** Print regressions over baseline, returns number of failed cases */
+	int CompareBaseline(const BenchOptions& Options, const std::map<std::string, BaselineResult>& Baseline, const std::vector<BenchResult>& Results)
+	{
+		int Regressions = 0, Compared = 0;
+		for (const BenchResult& Result : Results) {
+			const auto Found = Baseline.find(Result.Name);
+			if (Found == Baseline.end()) continue;
+			++Compared;
+			const double Milliseconds = Result.MeshSeconds * 1e3;
+			const double MaxMilliseconds = Found->second.MeshMilliseconds * (1.0 + Options.MaxTimeRegression);
+			const double MaxTriangles = (double)Found->second.Triangles * (1.0 + Options.MaxTriangleRegression);
+			bool bRegression = false;
+			if (MaxMilliseconds < Milliseconds && Options.MinTimeMilliseconds <= Milliseconds) {
+				std::printf("regression %s: mesh %.3f ms, baseline %.3f ms\n", Result.Name.c_str(), Milliseconds, Found->second.MeshMilliseconds);
+				bRegression = true;
+			}
+			if (MaxTriangles < (double)Result.Triangles) {
+				std::printf("regression %s: %zu triangles, baseline %zu\n", Result.Name.c_str(), Result.Triangles, Found->second.Triangles);
+				bRegression = true;
+			}
+			Regressions += bRegression;
+		}
+		std::printf("baseline %d cases compared, %d regressed\n", Compared, Regressions);
+		return Regressions;
+	}
+
+	double Rate(double Amount, double Seconds)
+	{
+		return 0.0 < Seconds ? Amount / Seconds : 0.0;
+	}
+
+	void PrintHeader()
+	{
+		std::printf("%-44s %10s %6s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+			"case", "bytes", "models", "cells", "vertices", "triangles", "instances", "parse ms", "volume ms", "mesh ms", "inst ms", "memory KB");
+	}
+
+	void PrintResult(const BenchResult& Result)
+	{
+		std::printf("%-44s %10zu %6zu %10zu %10zu %10zu %10zu %10.3f %10.3f %10.3f %10.3f %10zu\n",
+			Result.Name.c_str(), Result.Bytes, Result.Models, Result.Cells, Result.Vertices, Result.Triangles, Result.Instances,
+			Result.ParseSeconds * 1e3, Result.VolumeSeconds * 1e3, Result.MeshSeconds * 1e3, Result.InstanceSeconds * 1e3, Result.MemoryBytes / 1024);
+	}
+
+	void WriteCsv(const BenchOptions& Options, const std::vector<BenchResult>& Results)
+	{
+		std::FILE* Stream = std::fopen(Options.Csv.c_str(), "a+");
+		if (!Stream) {
+			std::fprintf(stderr, "%s: can not write\n", Options.Csv.c_str());
+			return;
+		}
+		std::fseek(Stream, 0, SEEK_END);
+		if (std::ftell(Stream) == 0) {
+			std::fprintf(Stream, "label,case,bytes,models,cells,vertices,triangles,instances,parse_ms,volume_ms,mesh_ms,instance_ms,memory_kb\n");
+		}
+		for (const BenchResult& Result : Results) {
+			std::fprintf(Stream, "%s,%s,%zu,%zu,%zu,%zu,%zu,%zu,%.4f,%.4f,%.4f,%.4f,%zu\n",
+				Options.Label.c_str(), Result.Name.c_str(), Result.Bytes, Result.Models, Result.Cells, Result.Vertices, Result.Triangles, Result.Instances,
+				Result.ParseSeconds * 1e3, Result.VolumeSeconds * 1e3, Result.MeshSeconds * 1e3, Result.InstanceSeconds * 1e3, Result.MemoryBytes / 1024);
+		}
+		std::fclose(Stream);
+	}
+
+	/** Generate every combination of sweep parameters */
+	bool CollectSweep(const SweepOptions& Sweep, std::vector<VoxCore::GeneratorParams>& OutParams)
+	{
+		for (const std::string& ShapeName : Sweep.Shapes) {
+			VoxCore::GeneratorShape Shape;
+			if (!VoxCore::GeneratorParams::ParseShape(ShapeName, Shape)) {
+				std::fprintf(stderr, "unknown shape %s\n", ShapeName.c_str());
+				return false;
+			}
+			for (int32_t Size : Sweep.Sizes) {
+				for (float Fill : Sweep.Fills) {
+					for (int32_t Colors : Sweep.Colors) {
+						for (int32_t Models : Sweep.Models) {
+							for (int32_t Depth : Sweep.Depths) {
+								VoxCore::GeneratorParams Params;
+								Params.Shape = Shape;
+								Params.Size = VoxCore::Int3(Size, Size, Size);
+								Params.Fill = Fill;
+								Params.Colors = Colors;
+								Params.Models = Models;
+								Params.Depth = Depth;
+								OutParams.push_back(Params);
+							}
+						}
+					}
+				}
+			}
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions Options;
+	if (!ParseArguments(argc, argv, Options)) {
+		PrintUsage();
+		return 2;
+	}
+
+	std::vector<BenchResult> Results;
+	BenchResult Total;
+	Total.Name = "total";
+	int Failures = 0;
+	const auto Add = [&](const BenchResult& Result) {
+		PrintResult(Result);
+		if (Options.bCheck) {
+			for (const std::string& Error : Result.Errors) {
+				std::printf("  error: %s\n", Error.c_str());
+			}
+			std::printf("  check %s: %zu triangles, naive %zu, %zu t-junctions allowed\n",
+				Result.Errors.empty() ? "ok" : "FAILED", Result.Triangles, Result.NaiveTriangles, Result.TJunctions);
+			Failures += !Result.Errors.empty();
+		}
+		if (Options.bLightmap) {
+			std::printf("  lightmap: %zu charts, %.0f texels, coverage %.3f, %.3f ms, %zu models not packed\n",
+				Result.Charts, Result.LightmapTexels, Rate(Result.ChartTexels, Result.LightmapTexels), Result.LightmapSeconds * 1e3, Result.Unpacked);
+		}
+		Total.Bytes += Result.Bytes;
+		Total.Models += Result.Models;
+		Total.Cells += Result.Cells;
+		Total.Vertices += Result.Vertices;
+		Total.Triangles += Result.Triangles;
+		Total.Instances += Result.Instances;
+		Total.ParseSeconds += Result.ParseSeconds;
+		Total.VolumeSeconds += Result.VolumeSeconds;
+		Total.MeshSeconds += Result.MeshSeconds;
+		Total.InstanceSeconds += Result.InstanceSeconds;
+		Total.Charts += Result.Charts;
+		Total.LightmapSeconds += Result.LightmapSeconds;
+		Total.LightmapTexels += Result.LightmapTexels;
+		Total.ChartTexels += Result.ChartTexels;
+		Total.Unpacked += Result.Unpacked;
+		Total.MemoryBytes = std::max(Total.MemoryBytes, Result.MemoryBytes);
+		Results.push_back(Result);
+	};
+
+	if (Options.bSweep) {
+		std::vector<VoxCore::GeneratorParams> Sweep;
+		if (!CollectSweep(Options.Sweep, Sweep)) {
+			return 2;
+		}
+		PrintHeader();
+		for (const VoxCore::GeneratorParams& Params : Sweep) {
+			BenchResult Result;
+			if (Bench(Params.GetName(), VoxCore::VoxGenerator::Generate(Params), Options, Result)) {
+				Add(Result);
+			} else {
+				++Failures;
+			}
+		}
+	} else {
+		std::vector<std::filesystem::path> Files;
+		CollectFiles(Options.Paths, Files);
+		if (Files.empty()) {
+			std::fprintf(stderr, "no vox files found\n");
+			return 2;
+		}
+		PrintHeader();
+		for (const auto& Path : Files) {
+			std::vector<uint8_t> Data;
+			BenchResult Result;
+			if (!ReadFile(Path, Data)) {
+				std::fprintf(stderr, "%s: can not read\n", Path.string().c_str());
+				++Failures;
+			} else if (Bench(Path.filename().string(), Data, Options, Result)) {
+				Add(Result);
+			} else {
+				++Failures;
+			}
+		}
+	}
+	Results.push_back(Total);
+
+	std::printf("\n%zu cases, %zu models, %zu cells, %zu triangles\n", Results.size() - 1, Total.Models, Total.Cells, Total.Triangles);
+	std::printf("parse     %10.2f MB/s\n", Rate(Total.Bytes / (1024.0 * 1024.0), Total.ParseSeconds));
+	std::printf("volume    %10.2f Mcells/s\n", Rate(Total.Cells / 1e6, Total.VolumeSeconds));
+	std::printf("mesh      %10.2f Mcells/s, %.2f Mtriangles/s\n", Rate(Total.Cells / 1e6, Total.MeshSeconds), Rate(Total.Triangles / 1e6, Total.MeshSeconds));
+	std::printf("instances %10.2f Mcells/s\n", Rate(Total.Cells / 1e6, Total.InstanceSeconds));
+	if (Options.bLightmap) {
+		std::printf("lightmap  %10.2f Mcharts/s, coverage %.3f, %zu models not packed\n",
+			Rate(Total.Charts / 1e6, Total.LightmapSeconds), Rate(Total.ChartTexels, Total.LightmapTexels), Total.Unpacked);
+	}
+	std::printf("peak memory %.1f MB\n", PeakMemory());
+
+	if (!Options.Baseline.empty()) {
+		std::map<std::string, BaselineResult> Baseline;
+		if (ReadBaseline(Options.Baseline, Baseline)) {
+			Failures += CompareBaseline(Options, Baseline, Results);
+		} else {
+			std::fprintf(stderr, "%s: can not read baseline\n", Options.Baseline.c_str());
+			++Failures;
+		}
+	}
+	if (!Options.Csv.empty()) {
+		WriteCsv(Options, Results);
+	}
+	return Failures == 0 ? 0 : 1;
+}
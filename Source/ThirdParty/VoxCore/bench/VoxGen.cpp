@@ -0,0 +1,106 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+/**
+ * VoxGen
+ * Write synthetic vox files of controlled size and density.
+ *   VoxGen [--shape noise|terrain|shell|solid] [--size X Y Z] [--fill R]
+ *          [--colors N] [--models N] [--depth N] [--seed N] FILE
+ *   VoxGen --corpus DIR
+ * Corpus writes every shape in sizes 16 to 256 to seed a benchmark corpus.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include "VoxGenerator.h"
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"usage: VoxGen [--shape noise|terrain|shell|solid] [--size X Y Z] [--fill R] [--colors N] [--models N] [--depth N] [--seed N] FILE\n"
+			"       VoxGen --corpus DIR\n");
+	}
+
+	bool WriteFile(const std::string& Path, const VoxCore::GeneratorParams& Params)
+	{
+		const std::vector<uint8_t> Data = VoxCore::VoxGenerator::Generate(Params);
+		std::FILE* Stream = std::fopen(Path.c_str(), "wb");
+		if (!Stream) {
+			std::fprintf(stderr, "%s: can not write\n", Path.c_str());
+			return false;
+		}
+		const bool bWritten = std::fwrite(Data.data(), 1, Data.size(), Stream) == Data.size();
+		std::fclose(Stream);
+		std::printf("%s %zu bytes\n", Path.c_str(), Data.size());
+		return bWritten;
+	}
+
+	bool WriteCorpus(const std::string& Directory)
+	{
+		std::error_code Error;
+		std::filesystem::create_directories(Directory, Error);
+		bool bResult = true;
+		for (int32_t Size : { 16, 64, 256 }) {
+			for (VoxCore::GeneratorShape Shape : { VoxCore::GeneratorShape::Noise, VoxCore::GeneratorShape::Terrain, VoxCore::GeneratorShape::Shell, VoxCore::GeneratorShape::Solid }) {
+				VoxCore::GeneratorParams Params;
+				Params.Shape = Shape;
+				Params.Size = VoxCore::Int3(Size, Size, Size);
+				Params.Fill = Shape == VoxCore::GeneratorShape::Noise ? 0.3f : Shape == VoxCore::GeneratorShape::Terrain ? 0.5f : 1.f;
+				Params.Colors = 16;
+				bResult &= WriteFile((std::filesystem::path(Directory) / (Params.GetName() + ".vox")).string(), Params);
+			}
+		}
+		//scene of many small models
+		VoxCore::GeneratorParams Params;
+		Params.Shape = VoxCore::GeneratorShape::Terrain;
+		Params.Size = VoxCore::Int3(32, 32, 32);
+		Params.Models = 64;
+		Params.Depth = 4;
+		bResult &= WriteFile((std::filesystem::path(Directory) / (Params.GetName() + ".vox")).string(), Params);
+		return bResult;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	VoxCore::GeneratorParams Params;
+	std::string Output;
+	for (int i = 1; i < argc; ++i) {
+		const std::string Arg = argv[i];
+		if (Arg == "--corpus" && i + 1 < argc) {
+			return WriteCorpus(argv[++i]) ? 0 : 1;
+		} else if (Arg == "--shape" && i + 1 < argc) {
+			if (!VoxCore::GeneratorParams::ParseShape(argv[++i], Params.Shape)) {
+				PrintUsage();
+				return 2;
+			}
+		} else if (Arg == "--size" && i + 3 < argc) {
+			Params.Size.X = std::atoi(argv[++i]);
+			Params.Size.Y = std::atoi(argv[++i]);
+			Params.Size.Z = std::atoi(argv[++i]);
+		} else if (Arg == "--fill" && i + 1 < argc) {
+			Params.Fill = (float)std::atof(argv[++i]);
+		} else if (Arg == "--colors" && i + 1 < argc) {
+			Params.Colors = std::atoi(argv[++i]);
+		} else if (Arg == "--models" && i + 1 < argc) {
+			Params.Models = std::atoi(argv[++i]);
+		} else if (Arg == "--depth" && i + 1 < argc) {
+			Params.Depth = std::atoi(argv[++i]);
+		} else if (Arg == "--seed" && i + 1 < argc) {
+			Params.Seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+		} else if (Arg.size() > 1 && Arg[0] == '-') {
+			PrintUsage();
+			return 2;
+		} else {
+			Output = Arg;
+		}
+	}
+	if (Output.empty()) {
+		PrintUsage();
+		return 2;
+	}
+	return WriteFile(Output, Params) ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "VoxCore/VoxFile.h"
+#include "VoxCore/VoxWriter.h"
+
+namespace VoxCore
+{
+
+/** Shape of generated model */
+enum class GeneratorShape
+{
+	/** Independent random cells, worst case for merging faces */
+	Noise,
+	/** Columns up to fractal noise height map */
+	Terrain,
+	/** One cell thick ellipsoid surface with empty inside */
+	Shell,
+	/** Every cell filled */
+	Solid,
+};
+
+/**
+ * @struct GeneratorParams
+ * Parameters of synthetic vox file.
+ */
+struct GeneratorParams
+{
+	GeneratorShape Shape = GeneratorShape::Noise;
+	/** Model size, at most 256 each axis */
+	Int3 Size = Int3(32, 32, 32);
+	/** Probability of cell for noise and shell, height scale for terrain */
+	float Fill = 0.5f;
+	/** Palette indices used, 1 to 255 */
+	int32_t Colors = 8;
+	/** Models in file, each generated with own seed */
+	int32_t Models = 1;
+	/** Nested transform and group levels above shape nodes, 0 writes no scene graph */
+	int32_t Depth = 0;
+	uint32_t Seed = 1;
+
+	/** Name of shape for command line and report */
+	static const char* GetShapeName(GeneratorShape Shape)
+	{
+		switch (Shape) {
+		case GeneratorShape::Noise: return "noise";
+		case GeneratorShape::Terrain: return "terrain";
+		case GeneratorShape::Shell: return "shell";
+		case GeneratorShape::Solid: return "solid";
+		}
+		return "";
+	}
+
+	static bool ParseShape(const std::string& Name, GeneratorShape& OutShape)
+	{
+		for (GeneratorShape Shape : { GeneratorShape::Noise, GeneratorShape::Terrain, GeneratorShape::Shell, GeneratorShape::Solid }) {
+			if (Name == GetShapeName(Shape)) {
+				OutShape = Shape;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Unique name of parameters, used as file name and case of report */
+	std::string GetName() const
+	{
+		char Buffer[128];
+		std::snprintf(Buffer, sizeof(Buffer), "%s_%dx%dx%d_f%.2f_c%d_m%d_d%d_s%u",
+			GetShapeName(Shape), Size.X, Size.Y, Size.Z, Fill, Colors, Models, Depth, Seed);
+		return Buffer;
+	}
+};
+
+/**
+ * VoxGenerator
+ * Generate vox data of controlled size and density.
+ */
+class VoxGenerator
+{
+public:
+
+	/** Generate cells of one model */
+	static void GenerateModel(const GeneratorParams& Params, uint32_t Seed, VoxModel& OutModel)
+	{
+		const Int3 Size(Clamp(Params.Size.X), Clamp(Params.Size.Y), Clamp(Params.Size.Z));
+		const int32_t Colors = std::max(1, std::min(255, Params.Colors));
+		OutModel.Size = Size;
+		OutModel.Cells.clear();
+		const auto Add = [&](int32_t X, int32_t Y, int32_t Z, uint32_t Color) {
+			OutModel.Cells.push_back(VoxCell{ (uint8_t)X, (uint8_t)Y, (uint8_t)Z, (uint8_t)(1 + Color % Colors) });
+		};
+		switch (Params.Shape) {
+		case GeneratorShape::Noise:
+			for (int32_t Z = 0; Z < Size.Z; ++Z) {
+				for (int32_t Y = 0; Y < Size.Y; ++Y) {
+					for (int32_t X = 0; X < Size.X; ++X) {
+						const uint32_t Hash = HashCell(Seed, X, Y, Z);
+						if (ToUnit(Hash) < Params.Fill) Add(X, Y, Z, Hash >> 8);
+					}
+				}
+			}
+			break;
+		case GeneratorShape::Terrain:
+			for (int32_t Y = 0; Y < Size.Y; ++Y) {
+				for (int32_t X = 0; X < Size.X; ++X) {
+					const float Noise = FractalNoise(Seed, X / 32.f, Y / 32.f);
+					const int32_t Height = std::min(Size.Z, 1 + (int32_t)(Params.Fill * Size.Z * Noise));
+					for (int32_t Z = 0; Z < Height; ++Z) {
+						//bands of height like strata
+						Add(X, Y, Z, (uint32_t)(Z * Colors / std::max(1, Size.Z)));
+					}
+				}
+			}
+			break;
+		case GeneratorShape::Shell: {
+			const float RX = Size.X * 0.5f, RY = Size.Y * 0.5f, RZ = Size.Z * 0.5f;
+			const auto Inside = [&](int32_t X, int32_t Y, int32_t Z) {
+				const float DX = (X + 0.5f - RX) / RX, DY = (Y + 0.5f - RY) / RY, DZ = (Z + 0.5f - RZ) / RZ;
+				return DX * DX + DY * DY + DZ * DZ <= 1.f;
+			};
+			for (int32_t Z = 0; Z < Size.Z; ++Z) {
+				for (int32_t Y = 0; Y < Size.Y; ++Y) {
+					for (int32_t X = 0; X < Size.X; ++X) {
+						if (!Inside(X, Y, Z)) continue;
+						const bool Surface = !Inside(X - 1, Y, Z) || !Inside(X + 1, Y, Z) || !Inside(X, Y - 1, Z)
+							|| !Inside(X, Y + 1, Z) || !Inside(X, Y, Z - 1) || !Inside(X, Y, Z + 1);
+						const uint32_t Hash = HashCell(Seed, X, Y, Z);
+						if (Surface && ToUnit(Hash) < Params.Fill) Add(X, Y, Z, (uint32_t)(Z * Colors / std::max(1, Size.Z)));
+					}
+				}
+			}
+			break;
+		}
+		case GeneratorShape::Solid:
+			for (int32_t Z = 0; Z < Size.Z; ++Z) {
+				for (int32_t Y = 0; Y < Size.Y; ++Y) {
+					for (int32_t X = 0; X < Size.X; ++X) {
+						Add(X, Y, Z, (uint32_t)((X / 8 + Y / 8 + Z / 8)));
+					}
+				}
+			}
+			break;
+		}
+	}
+
+	/** Generate vox data of every model, scene graph and palette */
+	static std::vector<uint8_t> Generate(const GeneratorParams& Params)
+	{
+		VoxWriter Writer;
+		const int32_t Models = std::max(1, Params.Models);
+		for (int32_t i = 0; i < Models; ++i) {
+			VoxModel Model;
+			GenerateModel(Params, Params.Seed * 7919u + (uint32_t)i, Model);
+			Writer.WriteModel(Model);
+		}
+		if (0 < Params.Depth) {
+			WriteScene(Writer, Params, Models);
+		}
+		Writer.WritePalette(GetPalette(Params.Seed));
+		return Writer.GetData();
+	}
+
+private:
+
+	/**
+	 * Root transform and group, then Depth - 1 nested transform and group
+	 * pairs, each shape placed side by side along x.
+	 */
+	static void WriteScene(VoxWriter& Writer, const GeneratorParams& Params, int32_t Models)
+	{
+		int32_t NextId = 0;
+		for (int32_t Level = 0; Level < Params.Depth; ++Level) {
+			const int32_t TransformId = NextId++;
+			const int32_t GroupId = NextId++;
+			Writer.WriteTransformNode(TransformId, GroupId, Int3());
+			if (Level + 1 < Params.Depth) {
+				Writer.WriteGroupNode(GroupId, { NextId });
+				continue;
+			}
+			std::vector<int32_t> Children;
+			for (int32_t i = 0; i < Models; ++i) {
+				Children.push_back(NextId + i * 2);
+			}
+			Writer.WriteGroupNode(GroupId, Children);
+		}
+		for (int32_t i = 0; i < Models; ++i) {
+			const int32_t TransformId = NextId++;
+			const int32_t ShapeId = NextId++;
+			VoxWriter::Dictionary Attributes = { { "_name", "model" + std::to_string(i) } };
+			Writer.WriteTransformNode(TransformId, ShapeId, Int3(i * (Params.Size.X + 1), 0, Params.Size.Z / 2), Attributes);
+			Writer.WriteShapeNode(ShapeId, i);
+		}
+	}
+
+	static std::vector<Color> GetPalette(uint32_t Seed)
+	{
+		std::vector<Color> Palette(256);
+		for (uint32_t i = 0; i < 256; ++i) {
+			const uint32_t Hash = HashCell(Seed, (int32_t)i, 0, 0);
+			Palette[i] = Color{ (uint8_t)Hash, (uint8_t)(Hash >> 8), (uint8_t)(Hash >> 16), 255 };
+		}
+		return Palette;
+	}
+
+	static int32_t Clamp(int32_t Value)
+	{
+		return std::max(1, std::min(256, Value));
+	}
+
+	static uint32_t HashCell(uint32_t Seed, int32_t X, int32_t Y, int32_t Z)
+	{
+		uint32_t Hash = Seed * 0x9E3779B9u;
+		Hash ^= (uint32_t)X * 0x85EBCA6Bu;
+		Hash ^= (uint32_t)Y * 0xC2B2AE35u;
+		Hash ^= (uint32_t)Z * 0x27D4EB2Fu;
+		Hash ^= Hash >> 15;
+		Hash *= 0x2C1B3C6Du;
+		Hash ^= Hash >> 12;
+		Hash *= 0x297A2D39u;
+		Hash ^= Hash >> 15;
+		return Hash;
+	}
+
+	static float ToUnit(uint32_t Hash)
+	{
+		return (Hash & 0xFFFFFF) / 16777216.f;
+	}
+
+	/** Smooth value noise on integer lattice in 0 to 1 */
+	static float ValueNoise(uint32_t Seed, float X, float Y)
+	{
+		const int32_t IX = (int32_t)std::floor(X), IY = (int32_t)std::floor(Y);
+		const float FX = X - IX, FY = Y - IY;
+		const float SX = FX * FX * (3.f - 2.f * FX), SY = FY * FY * (3.f - 2.f * FY);
+		const float V00 = ToUnit(HashCell(Seed, IX, IY, 0)), V10 = ToUnit(HashCell(Seed, IX + 1, IY, 0));
+		const float V01 = ToUnit(HashCell(Seed, IX, IY + 1, 0)), V11 = ToUnit(HashCell(Seed, IX + 1, IY + 1, 0));
+		const float A = V00 + (V10 - V00) * SX, B = V01 + (V11 - V01) * SX;
+		return A + (B - A) * SY;
+	}
+
+	/** Four octaves of value noise in 0 to 1 */
+	static float FractalNoise(uint32_t Seed, float X, float Y)
+	{
+		float Result = 0.f, Amplitude = 0.5f, Total = 0.f;
+		for (int32_t Octave = 0; Octave < 4; ++Octave) {
+			Result += Amplitude * ValueNoise(Seed + (uint32_t)Octave, X, Y);
+			Total += Amplitude;
+			X *= 2.f, Y *= 2.f, Amplitude *= 0.5f;
+		}
+		return Result / Total;
+	}
+};
+
+} // namespace VoxCore
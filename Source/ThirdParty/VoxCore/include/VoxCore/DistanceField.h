@@ -0,0 +1,264 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "VoxVolume.h"
+
+namespace VoxCore
+{
+
+/**
+ * @struct DistanceFieldOptions
+ * Sampling of distance field.
+ */
+struct DistanceFieldOptions
+{
+	/** Samples along cell edge */
+	int32_t SamplesPerCell;
+	/** Cells along sample edge, sample is solid if any of its cells is */
+	int32_t CellsPerSample;
+	/** Samples of empty space around model */
+	int32_t Margin;
+	/** Cell edge length along each axis */
+	float CellSize[3];
+
+	DistanceFieldOptions() : SamplesPerCell(1), CellsPerSample(1), Margin(2), CellSize{ 1.f, 1.f, 1.f } { }
+};
+
+/**
+ * @struct VoxDistanceField
+ * Signed distance at sample centers, negative inside.
+ */
+struct VoxDistanceField
+{
+	/** Samples along each axis */
+	Int3 Size;
+	/** Cell space position of first sample corner */
+	float Min[3];
+	/** Sample edge length along each axis, scaled by cell size like distances */
+	float SampleSize[3];
+	/** Distance of every sample, X first */
+	std::vector<float> Distances;
+
+	float Get(const Int3& Sample) const
+	{
+		return Distances[(size_t)Sample.X + (size_t)Size.X * ((size_t)Sample.Y + (size_t)Size.Y * (size_t)Sample.Z)];
+	}
+};
+
+/**
+ * DistanceField
+ * Exact euclidean distance transform of solid samples, separable in three
+ * passes of lower envelope of parabolas along each axis.
+ * @see Felzenszwalb and Huttenlocher, Distance Transforms of Sampled Functions
+ */
+class DistanceField
+{
+public:
+
+	DistanceField(const VoxVolume& InVolume, const DistanceFieldOptions& InOptions = DistanceFieldOptions())
+		: Volume(InVolume), Options(InOptions)
+	{
+	}
+
+	/** Samples along each axis of field */
+	Int3 GetSize() const
+	{
+		const Int3& CellSize = Volume.GetSize();
+		Int3 Result;
+		for (int Axis = 0; Axis < 3; ++Axis) {
+			const int32_t Samples = CellSize[Axis] * Options.SamplesPerCell;
+			Result[Axis] = (Samples + Options.CellsPerSample - 1) / Options.CellsPerSample + Options.Margin * 2;
+		}
+		return Result;
+	}
+
+	/**
+	 * Compute distance of every sample to nearest boundary of solid samples
+	 * Cells of model and occluded cells in model bounds are solid, padding
+	 * holds adjacent models and is ignored. Distance is measured between
+	 * sample centers less half a sample.
+	 * @return false if no sample is solid
+	 */
+	bool Create(VoxDistanceField& Out) const
+	{
+		Out.Size = GetSize();
+		const float Step = (float)Options.CellsPerSample / (float)Options.SamplesPerCell;
+		float Weight[3];
+		float HalfSample = 0.f;
+		for (int Axis = 0; Axis < 3; ++Axis) {
+			Out.SampleSize[Axis] = Step * Options.CellSize[Axis];
+			Out.Min[Axis] = -Step * (float)Options.Margin;
+			Weight[Axis] = Out.SampleSize[Axis] * Out.SampleSize[Axis];
+			HalfSample = Axis == 0 ? Out.SampleSize[0] * 0.5f : std::fmin(HalfSample, Out.SampleSize[Axis] * 0.5f);
+		}
+
+		std::vector<uint8_t> Solid;
+		if (!GetSolidSamples(Out.Size, Solid)) {
+			Out.Distances.clear();
+			return false;
+		}
+		//squared distance to nearest solid and nearest empty sample, finite
+		//so parabolas of two unreached samples never meet at NaN
+		const float Unreached = 1e20f;
+		std::vector<float> Outside(Solid.size()), Inside(Solid.size());
+		for (size_t i = 0; i < Solid.size(); ++i) {
+			Outside[i] = Solid[i] ? 0.f : Unreached;
+			Inside[i] = Solid[i] ? Unreached : 0.f;
+		}
+		Transform(Out.Size, Weight, Outside);
+		Transform(Out.Size, Weight, Inside);
+		Out.Distances.resize(Solid.size());
+		for (size_t i = 0; i < Solid.size(); ++i) {
+			Out.Distances[i] = Solid[i] ? HalfSample - std::sqrt(Inside[i]) : std::sqrt(Outside[i]) - HalfSample;
+		}
+		return true;
+	}
+
+private:
+
+	/** Solid flag of every sample, false if none */
+	bool GetSolidSamples(const Int3& Size, std::vector<uint8_t>& OutSolid) const
+	{
+		//cells covered by every sample along each axis
+		std::vector<int32_t> Begin[3], End[3];
+		for (int Axis = 0; Axis < 3; ++Axis) {
+			Begin[Axis].resize((size_t)Size[Axis]);
+			End[Axis].resize((size_t)Size[Axis]);
+			for (int32_t Sample = 0; Sample < Size[Axis]; ++Sample) {
+				const int32_t First = (Sample - Options.Margin) * Options.CellsPerSample;
+				const int32_t Last = First + Options.CellsPerSample;
+				Begin[Axis][(size_t)Sample] = Clamp(FloorDivide(First, Options.SamplesPerCell), 0, Volume.GetSize()[Axis]);
+				End[Axis][(size_t)Sample] = Clamp(FloorDivide(Last + Options.SamplesPerCell - 1, Options.SamplesPerCell), 0, Volume.GetSize()[Axis]);
+			}
+		}
+		OutSolid.assign((size_t)Size.X * (size_t)Size.Y * (size_t)Size.Z, 0);
+		bool bAnySolid = false;
+		size_t Index = 0;
+		for (int32_t z = 0; z < Size.Z; ++z) {
+			for (int32_t y = 0; y < Size.Y; ++y) {
+				for (int32_t x = 0; x < Size.X; ++x, ++Index) {
+					OutSolid[Index] = IsAnySolid(
+						Int3(Begin[0][(size_t)x], Begin[1][(size_t)y], Begin[2][(size_t)z]),
+						Int3(End[0][(size_t)x], End[1][(size_t)y], End[2][(size_t)z])) ? 1 : 0;
+					bAnySolid = bAnySolid || OutSolid[Index];
+				}
+			}
+		}
+		return bAnySolid;
+	}
+
+	bool IsAnySolid(const Int3& Begin, const Int3& End) const
+	{
+		Int3 Cell;
+		for (Cell.Z = Begin.Z; Cell.Z < End.Z; ++Cell.Z) {
+			for (Cell.Y = Begin.Y; Cell.Y < End.Y; ++Cell.Y) {
+				for (Cell.X = Begin.X; Cell.X < End.X; ++Cell.X) {
+					if (Volume.IsSolid(Cell)) return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/** Squared distance transform of every line along every axis, Values are 0 or unreached */
+	static void Transform(const Int3& Size, const float Weight[3], std::vector<float>& Values)
+	{
+		const size_t Stride[3] = { 1, (size_t)Size.X, (size_t)Size.X * (size_t)Size.Y };
+		int32_t MaxSize = Size.X > Size.Y ? Size.X : Size.Y;
+		MaxSize = MaxSize > Size.Z ? MaxSize : Size.Z;
+		std::vector<float> Line((size_t)MaxSize), Result((size_t)MaxSize), Boundaries((size_t)MaxSize + 1);
+		std::vector<int32_t> Parabolas((size_t)MaxSize);
+		for (int Axis = 0; Axis < 3; ++Axis) {
+			//lines next to each other along X share cache lines of strided passes
+			const int Axis1 = Axis == 0 ? 1 : 0;
+			const int Axis2 = Axis == 2 ? 1 : 2;
+			for (int32_t j = 0; j < Size[Axis2]; ++j) {
+				for (int32_t i = 0; i < Size[Axis1]; ++i) {
+					float* First = Values.data() + (size_t)i * Stride[Axis1] + (size_t)j * Stride[Axis2];
+					for (int32_t k = 0; k < Size[Axis]; ++k) {
+						Line[(size_t)k] = First[(size_t)k * Stride[Axis]];
+					}
+					if (Axis == 0) {
+						TransformFirstLine(Line.data(), Size[Axis], Weight[Axis], Result.data());
+					} else {
+						TransformLine(Line.data(), Size[Axis], Weight[Axis], Result.data(), Parabolas.data(), Boundaries.data());
+					}
+					for (int32_t k = 0; k < Size[Axis]; ++k) {
+						First[(size_t)k * Stride[Axis]] = Result[(size_t)k];
+					}
+				}
+			}
+		}
+	}
+
+	/** First pass on zero or unreached samples, distance to nearest zero on the line */
+	static void TransformFirstLine(const float* Line, int32_t Count, float Weight, float* OutResult)
+	{
+		int32_t Nearest = -1;
+		for (int32_t q = 0; q < Count; ++q) {
+			if (Line[q] == 0.f) Nearest = q;
+			OutResult[q] = Nearest < 0 ? Line[q] : Weight * (float)(q - Nearest) * (float)(q - Nearest);
+		}
+		Nearest = -1;
+		for (int32_t q = Count - 1; 0 <= q; --q) {
+			if (Line[q] == 0.f) Nearest = q;
+			if (0 <= Nearest) {
+				const float Distance = Weight * (float)(Nearest - q) * (float)(Nearest - q);
+				OutResult[q] = Distance < OutResult[q] ? Distance : OutResult[q];
+			}
+		}
+	}
+
+	/** Lower envelope of parabolas Weight * (x - q)^2 + Line[q] at every x */
+	static void TransformLine(const float* Line, int32_t Count, float Weight, float* OutResult, int32_t* Parabolas, float* Boundaries)
+	{
+		const float Infinity = std::numeric_limits<float>::infinity();
+		int32_t k = 0;
+		Parabolas[0] = 0;
+		Boundaries[0] = -Infinity;
+		Boundaries[1] = Infinity;
+		for (int32_t q = 1; q < Count; ++q) {
+			float s = Intersect(Line, Weight, q, Parabolas[k]);
+			while (s <= Boundaries[k]) {
+				s = Intersect(Line, Weight, q, Parabolas[--k]);
+			}
+			++k;
+			Parabolas[k] = q;
+			Boundaries[k] = s;
+			Boundaries[k + 1] = Infinity;
+		}
+		k = 0;
+		for (int32_t q = 0; q < Count; ++q) {
+			while (Boundaries[k + 1] < (float)q) ++k;
+			const float Distance = (float)(q - Parabolas[k]);
+			OutResult[q] = Weight * Distance * Distance + Line[Parabolas[k]];
+		}
+	}
+
+	/** Position where parabolas of q and p meet, p < q */
+	static float Intersect(const float* Line, float Weight, int32_t q, int32_t p)
+	{
+		return ((Line[q] + Weight * (float)q * (float)q) - (Line[p] + Weight * (float)p * (float)p)) / (2.f * Weight * (float)(q - p));
+	}
+
+	static int32_t FloorDivide(int32_t Value, int32_t Divisor)
+	{
+		return Value < 0 ? -((-Value + Divisor - 1) / Divisor) : Value / Divisor;
+	}
+
+	static int32_t Clamp(int32_t Value, int32_t Min, int32_t Max)
+	{
+		return Value < Min ? Min : Max < Value ? Max : Value;
+	}
+
+private:
+
+	const VoxVolume& Volume;
+	DistanceFieldOptions Options;
+};
+
+} // namespace VoxCore
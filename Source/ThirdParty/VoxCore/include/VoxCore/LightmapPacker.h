@@ -0,0 +1,184 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "MonotoneMesher.h"
+
+namespace VoxCore
+{
+
+/**
+ * @struct LightmapOptions
+ * Texel budget of lightmap.
+ */
+struct LightmapOptions
+{
+	/** Least and greatest lightmap edge in texels */
+	int32_t MinResolution;
+	int32_t MaxResolution;
+	/** Empty texels on every side of chart so filtering never bleeds between charts */
+	int32_t Gutter;
+
+	LightmapOptions() : MinResolution(32), MaxResolution(1024), Gutter(1) { }
+};
+
+/**
+ * @struct LightmapLayout
+ * Placement of every chart of mesh in lightmap.
+ */
+struct LightmapLayout
+{
+	struct Placement
+	{
+		/** Texel position of chart corner, gutter included */
+		int32_t X, Y;
+		/** Chart U runs along lightmap Y */
+		bool bRotated;
+	};
+
+	/** Lightmap edge in texels */
+	int32_t Resolution;
+	/** Texels along cell edge, 1 unless charts are shrunk to fit */
+	float TexelsPerCell;
+	/** Placement of every chart */
+	std::vector<Placement> Placements;
+	/** Texels covered by charts over lightmap texels */
+	float Coverage;
+};
+
+/**
+ * LightmapPacker
+ * Pack rectangle charts of mesh into square lightmap by shelves. Charts are
+ * turned to lie flat and sorted by height, then placed left to right on rows
+ * as tall as their first chart.
+ */
+class LightmapPacker
+{
+public:
+
+	LightmapPacker(const LightmapOptions& InOptions = LightmapOptions())
+		: Options(InOptions)
+	{
+	}
+
+	/**
+	 * Place every chart of mesh
+	 * Lightmap grows from charts area at one texel per cell until charts fit,
+	 * then texel density drops at greatest resolution. Edge of cell spans
+	 * 1 / Resolution of UV unless density dropped.
+	 * @return false if charts do not fit even at one texel each
+	 */
+	bool Pack(const VoxMesh& Mesh, LightmapLayout& Out) const
+	{
+		Out.Placements.resize(Mesh.Charts.size());
+		std::vector<uint32_t> Order(Mesh.Charts.size());
+		int64_t Texels = 0;
+		for (size_t Index = 0; Index < Order.size(); ++Index) {
+			const LightmapChart& Chart = Mesh.Charts[Index];
+			Order[Index] = (uint32_t)Index;
+			Out.Placements[Index].bRotated = Chart.Width < Chart.Height;
+			Texels += (int64_t)GetTexels(Chart.Width, 1.f) * GetTexels(Chart.Height, 1.f);
+		}
+		const int64_t LeastTexels = (int64_t)GetTexels(0, 1.f) * GetTexels(0, 1.f) * (int64_t)Order.size();
+		if ((int64_t)Options.MaxResolution * Options.MaxResolution < LeastTexels) {
+			return false;
+		}
+		//tallest first, order holds at every density since texel size rounds up
+		std::sort(Order.begin(), Order.end(), [&](uint32_t A, uint32_t B) {
+			const int32_t HeightA = std::min(Mesh.Charts[A].Width, Mesh.Charts[A].Height);
+			const int32_t HeightB = std::min(Mesh.Charts[B].Width, Mesh.Charts[B].Height);
+			return HeightA != HeightB ? HeightB < HeightA : A < B;
+		});
+		Out.TexelsPerCell = 1.f;
+		const int32_t Side = (int32_t)std::ceil(std::sqrt((double)Texels));
+		for (Out.Resolution = RoundUp(std::max(Options.MinResolution, Side)); Out.Resolution < Options.MaxResolution; Out.Resolution = RoundUp(Out.Resolution + Out.Resolution / 16)) {
+			if (PackShelves(Mesh, Order, Out)) {
+				return true;
+			}
+		}
+		Out.Resolution = Options.MaxResolution;
+		for (; ; Out.TexelsPerCell *= 0.8f) {
+			if (PackShelves(Mesh, Order, Out)) {
+				return true;
+			}
+			//every chart is down to one texel
+			if (Out.TexelsPerCell * (float)GetLongestSide(Mesh) < 1.f) {
+				return false;
+			}
+		}
+	}
+
+	/** Lightmap UV of every wedge, U and V interleaved */
+	void GetWedgeUVs(const VoxMesh& Mesh, const LightmapLayout& Layout, std::vector<float>& OutUVs) const
+	{
+		OutUVs.resize(Mesh.Indices.size() * 2);
+		const float TexelToUV = 1.f / (float)Layout.Resolution;
+		for (size_t Wedge = 0; Wedge < Mesh.Indices.size(); ++Wedge) {
+			const uint32_t ChartIndex = Mesh.TriangleCharts[Wedge / 3];
+			const LightmapChart& Chart = Mesh.Charts[ChartIndex];
+			const LightmapLayout::Placement& Placement = Layout.Placements[ChartIndex];
+			const Int3& Position = Mesh.Positions[Mesh.Indices[Wedge]];
+			const float U = (float)(Position[Chart.AxisU] - Chart.Origin[Chart.AxisU]) * Layout.TexelsPerCell;
+			const float V = (float)(Position[Chart.AxisV] - Chart.Origin[Chart.AxisV]) * Layout.TexelsPerCell;
+			OutUVs[Wedge * 2] = ((float)(Placement.X + Options.Gutter) + (Placement.bRotated ? V : U)) * TexelToUV;
+			OutUVs[Wedge * 2 + 1] = ((float)(Placement.Y + Options.Gutter) + (Placement.bRotated ? U : V)) * TexelToUV;
+		}
+	}
+
+private:
+
+	bool PackShelves(const VoxMesh& Mesh, const std::vector<uint32_t>& Order, LightmapLayout& Out) const
+	{
+		const int32_t Resolution = Out.Resolution;
+		int32_t X = 0, Y = 0, ShelfHeight = 0;
+		int64_t Covered = 0;
+		for (uint32_t Index : Order) {
+			const LightmapChart& Chart = Mesh.Charts[Index];
+			LightmapLayout::Placement& Placement = Out.Placements[Index];
+			const int32_t Width = GetTexels(Placement.bRotated ? Chart.Height : Chart.Width, Out.TexelsPerCell);
+			const int32_t Height = GetTexels(Placement.bRotated ? Chart.Width : Chart.Height, Out.TexelsPerCell);
+			if (Resolution < X + Width) {
+				X = 0, Y += ShelfHeight, ShelfHeight = 0;
+			}
+			if (Resolution < X + Width || Resolution < Y + Height) {
+				return false;
+			}
+			Placement.X = X, Placement.Y = Y;
+			X += Width;
+			ShelfHeight = std::max(ShelfHeight, Height);
+			Covered += (int64_t)(Width - Options.Gutter * 2) * (Height - Options.Gutter * 2);
+		}
+		Out.Coverage = (float)((double)Covered / ((double)Resolution * Resolution));
+		return true;
+	}
+
+	/** Least multiple of 4 not below Value */
+	static int32_t RoundUp(int32_t Value)
+	{
+		return (Value + 3) & ~3;
+	}
+
+	/** Texels of chart side with gutters */
+	int32_t GetTexels(int32_t Cells, float TexelsPerCell) const
+	{
+		return std::max(1, (int32_t)std::ceil((float)Cells * TexelsPerCell)) + Options.Gutter * 2;
+	}
+
+	static int32_t GetLongestSide(const VoxMesh& Mesh)
+	{
+		int32_t Longest = 0;
+		for (const LightmapChart& Chart : Mesh.Charts) {
+			Longest = std::max(Longest, std::max(Chart.Width, Chart.Height));
+		}
+		return Longest;
+	}
+
+private:
+
+	LightmapOptions Options;
+};
+
+} // namespace VoxCore
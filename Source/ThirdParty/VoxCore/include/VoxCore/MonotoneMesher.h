@@ -0,0 +1,605 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "VisibilityKernel.h"
+#include "VoxVolume.h"
+
+namespace VoxCore
+{
+
+/**
+ * @struct MeshOptions
+ * Output of mesher.
+ */
+struct MeshOptions
+{
+	/** Write corner occlusion level of every wedge */
+	bool bAmbientOcclusion;
+	/** Material index by face direction, Up, Down, Forward, Backward, Right, Left */
+	bool bGroupByDirection;
+	/** Write chart of every merged polygon for lightmap */
+	bool bLightmapCharts;
+
+	MeshOptions() : bAmbientOcclusion(false), bGroupByDirection(false), bLightmapCharts(false) { }
+};
+
+/**
+ * @struct LightmapChart
+ * Bounding rectangle of merged polygon in its plane, in cells.
+ */
+struct LightmapChart
+{
+	/** Volume position of corner with least U and V */
+	Int3 Origin;
+	/** Volume axis along U and V of chart */
+	int32_t AxisU, AxisV;
+	/** Cells along U and V */
+	int32_t Width, Height;
+};
+
+/**
+ * @struct VoxMesh
+ * Indexed triangles on cell corners.
+ */
+struct VoxMesh
+{
+	/** Welded vertex positions */
+	std::vector<Int3> Positions;
+	/** Three position indices per triangle */
+	std::vector<uint32_t> Indices;
+	/** Palette index per triangle */
+	std::vector<uint8_t> Colors;
+	/** Material index per triangle */
+	std::vector<uint8_t> Materials;
+	/** Corner occlusion level 0 to 3 per wedge, empty unless requested */
+	std::vector<uint8_t> WedgeAO;
+	/** Chart of every merged polygon, empty unless requested */
+	std::vector<LightmapChart> Charts;
+	/** Chart index per triangle, empty unless requested */
+	std::vector<uint32_t> TriangleCharts;
+
+	size_t GetNumTriangles() const { return Indices.size() / 3; }
+};
+
+/**
+ * @struct Face
+ * Faces in horizontal scan line
+ */
+struct Face
+{
+	/** Voxel color index, negative if face looks toward +Axis.Z */
+	int Color;
+	/** Start left */
+	int Left;
+	/** End right */
+	int Right;
+	/** Ambient occlusion of every corner, -1 if corners differ */
+	int AO;
+	/** Ambient occlusion of corners (x0y0, x1y0, x0y1, x1y1) */
+	int CornerAO[4];
+
+	Face(int color, int left, int right, int ao = 3) {
+		Color = color, Left = left, Right = right, AO = ao;
+		CornerAO[0] = CornerAO[1] = CornerAO[2] = CornerAO[3] = ao;
+	}
+
+	/** Faces of different corner occlusion are kept single cell to interpolate correctly */
+	bool CanMerge(int color, int ao) const {
+		return Color == color && AO == ao && 0 <= AO;
+	}
+};
+
+/**
+ * @struct Polygon
+ * Monotone polygon
+ */
+struct Polygon
+{
+	/** Voxel color index */
+	int Color;
+	/** Vertices left side */
+	std::vector<Int3> Left;
+	/** Vertices right side */
+	std::vector<Int3> Right;
+	/** Ambient occlusion of every vertex, -1 for single cell uses CornerAO */
+	int AO;
+	/** Ambient occlusion of corners (x0y0, x1y0, x0y1, x1y1) */
+	int CornerAO[4];
+
+	Polygon(const Face& face, int y, int z) {
+		Color = face.Color;
+		Left.push_back(Int3(face.Left, y, z));
+		Right.push_back(Int3(face.Right, y, z));
+		AO = face.AO;
+		for (int i = 0; i < 4; ++i) CornerAO[i] = face.CornerAO[i];
+	}
+
+	/** Merge cells each scan lines */
+	void Merge(int left, int right, int y, int z) {
+		auto ll = Left.back().X;
+		auto lr = Right.back().X;
+		if (ll != left) {
+			Left.push_back(Int3(ll, y, z));
+			Left.push_back(Int3(left, y, z));
+		}
+		if (lr != right) {
+			Right.push_back(Int3(lr, y, z));
+			Right.push_back(Int3(right, y, z));
+		}
+	}
+
+	/** Close off monotone polygon */
+	void CloseOff(int y, int z) {
+		auto ll = Left.back().X;
+		auto lr = Right.back().X;
+		Left.push_back(Int3(ll, y, z));
+		Right.push_back(Int3(lr, y, z));
+	}
+};
+
+/**
+ * @struct ScanAxis
+ * Component order of scan along dimension, X walks a row, Y steps rows and
+ * Z steps planes. Compile time constants so indexing folds away.
+ */
+template<int Dimension>
+struct ScanAxis
+{
+	static const int X = Dimension;
+	static const int Y = (Dimension + 1) % 3;
+	static const int Z = (Dimension + 2) % 3;
+	/** Direction index of Up, Down, Forward, Backward, Right, Left order for face looking toward +Z */
+	static const int Direction = Z == 2 ? 0 : Z == 0 ? 2 : 4;
+
+	/** Volume coordinates of scan coordinates */
+	static Int3 ToVolume(int x, int y, int z)
+	{
+		Int3 Result;
+		Result[X] = x, Result[Y] = y, Result[Z] = z;
+		return Result;
+	}
+};
+
+/**
+ * Monotone mesh generation
+ * @see https://0fps.net/2012/07/07/meshing-minecraft-part-2/
+ */
+class MonotoneMesher
+{
+public:
+
+	MonotoneMesher(const VoxVolume& InVolume, const MeshOptions& InOptions = MeshOptions())
+		: Volume(InVolume), Options(InOptions)
+	{
+	}
+
+	/** Append mesh of every visible face */
+	void CreateMesh(VoxMesh& OutMesh) const
+	{
+		WeldMap Weld;
+		std::vector<uint8_t> Cells, Occluded;
+		CreateMesh<0>(OutMesh, Weld, Cells, Occluded);
+		CreateMesh<1>(OutMesh, Weld, Cells, Occluded);
+		CreateMesh<2>(OutMesh, Weld, Cells, Occluded);
+	}
+
+private:
+
+	typedef std::unordered_map<uint64_t, uint32_t> WeldMap;
+
+	/**
+	 * @struct Slices
+	 * Padded cells ordered Axis X fastest and Axis Z slowest, so every plane
+	 * is one contiguous slice and every scan line one contiguous row.
+	 */
+	struct Slices
+	{
+		const uint8_t* Cells;
+		const uint8_t* Occluded;
+		/** Cells per row and per slice, padding included */
+		size_t Pitch;
+		size_t Size;
+	};
+
+	/**
+	 * CreateMesh
+	 * Append faces of every plane along dimension
+	 * @param Cells Storage of transposed cells
+	 * @param Occluded Storage of transposed occluded
+	 */
+	template<int Dimension>
+	void CreateMesh(VoxMesh& OutMesh, WeldMap& Weld, std::vector<uint8_t>& Cells, std::vector<uint8_t>& Occluded) const
+	{
+		typedef ScanAxis<Dimension> Axis;
+		const Int3& Size = Volume.GetSize();
+		Slices Slice;
+		GetSlices<Dimension>(Cells, Occluded, Slice);
+		auto Color = std::vector<uint8_t>(Slice.Size + VisibilityKernel::Padding);
+		auto Flipped = std::vector<uint8_t>(Slice.Size + VisibilityKernel::Padding);
+		auto Polygons = std::vector<Polygon>();
+		for (auto z = 0; z <= Size[Axis::Z]; ++z) {
+			//padded slice index of back cells is z - 1 + 1
+			const size_t Back = (size_t)z * Slice.Size, Front = Back + Slice.Size;
+			VisibilityKernel::Compute(Slice.Cells + Back, Slice.Cells + Front, Slice.Occluded + Back, Slice.Occluded + Front,
+				Color.data(), Flipped.data(), Slice.Size);
+			Polygons.clear();
+			CreatePolygons<Dimension>(Polygons, z, Color.data(), Flipped.data(), Slice.Pitch);
+			for (const auto& Polygon : Polygons) {
+				if (Polygon.Color < 0) {
+					WritePolygon<Dimension, true>(OutMesh, Weld, Polygon);
+				} else {
+					WritePolygon<Dimension, false>(OutMesh, Weld, Polygon);
+				}
+			}
+		}
+	}
+
+	/**
+	 * GetSlices
+	 * Slices of volume along dimension, volume itself along X or transposed copy otherwise
+	 * @param Cells Storage of transposed cells
+	 * @param Occluded Storage of transposed occluded
+	 */
+	template<int Dimension>
+	void GetSlices(std::vector<uint8_t>& Cells, std::vector<uint8_t>& Occluded, Slices& OutSlices) const
+	{
+		typedef ScanAxis<Dimension> Axis;
+		const Int3& Size = Volume.GetSize();
+		const Int3& Stride = Volume.GetStride();
+		OutSlices.Pitch = (size_t)Size[Axis::X] + 2;
+		OutSlices.Size = OutSlices.Pitch * (Size[Axis::Y] + 2);
+		if (Axis::X == 0) {
+			OutSlices.Cells = Volume.GetCells();
+			OutSlices.Occluded = Volume.GetOccluded();
+			return;
+		}
+		Cells.resize(OutSlices.Size * (Size[Axis::Z] + 2) + VisibilityKernel::Padding);
+		Occluded.resize(Cells.size());
+		const uint8_t* SourceCells = Volume.GetCells();
+		const uint8_t* SourceOccluded = Volume.GetOccluded();
+		const size_t StrideX = Stride[Axis::X];
+		size_t Index = 0;
+		for (auto c = 0; c < Size[Axis::Z] + 2; ++c) {
+			for (auto b = 0; b < Size[Axis::Y] + 2; ++b) {
+				size_t Source = (size_t)c * Stride[Axis::Z] + (size_t)b * Stride[Axis::Y];
+				for (auto a = 0; a < Size[Axis::X] + 2; ++a, ++Index, Source += StrideX) {
+					Cells[Index] = SourceCells[Source];
+					Occluded[Index] = SourceOccluded[Source];
+				}
+			}
+		}
+		OutSlices.Cells = Cells.data();
+		OutSlices.Occluded = Occluded.data();
+	}
+
+	/**
+	 * CreatePolygons
+	 * Create monotone polygons each voxel types in any faces of volumes
+	 * @param OutPolygons Out polygons
+	 * @param z Plane of polygon faces
+	 * @param ColorSlice Padded slice of visible face colors
+	 * @param FlippedSlice Padded slice of visible face sides
+	 * @param Pitch Cells per row of slice
+	 */
+	template<int Dimension>
+	void CreatePolygons(std::vector<Polygon>& OutPolygons, int z, uint8_t* ColorSlice, uint8_t* FlippedSlice, size_t Pitch) const
+	{
+		typedef ScanAxis<Dimension> Axis;
+		const Int3& Size = Volume.GetSize();
+		const auto Width = Size[Axis::X];
+		auto Frontier = std::vector<int>();
+		auto NextFrontier = std::vector<int>();
+		auto Faces = std::vector<Face>();
+		auto RunStarts = std::vector<uint64_t>(Width / 64 + 1);
+		for (auto y = 0; y < Size[Axis::Y]; ++y) {
+			Faces.clear();
+			uint8_t* ColorRow = ColorSlice + (y + 1) * Pitch + 1;
+			uint8_t* FlippedRow = FlippedSlice + (y + 1) * Pitch + 1;
+			//padding ends runs
+			ColorRow[-1] = ColorRow[Width] = 0;
+			FlippedRow[-1] = FlippedRow[Width] = 0;
+			if (Options.bAmbientOcclusion) {
+				CreateFaces<Dimension>(Faces, y, z, ColorRow, FlippedRow);
+			} else {
+				CreateRuns(Faces, Width, ColorRow, FlippedRow, RunStarts.data());
+			}
+			NextFrontier.clear();
+			size_t FrontierIndex = 0, FaceIndex = 0;
+			while (FrontierIndex < Frontier.size() && FaceIndex < Faces.size()) {
+				auto& Polygon = OutPolygons[Frontier[FrontierIndex]];
+				const auto Color = Polygon.Color;
+				const auto Left = Polygon.Left.back().X;
+				const auto Right = Polygon.Right.back().X;
+				const auto& Face = Faces[FaceIndex];
+				if (Left < Face.Right && Face.Left < Right && Face.CanMerge(Color, Polygon.AO)) {
+					Polygon.Merge(Face.Left, Face.Right, y, z);
+					NextFrontier.push_back(Frontier[FrontierIndex]);
+					++FrontierIndex, ++FaceIndex;
+				} else {
+					if (Right <= Face.Right) {
+						Polygon.CloseOff(y, z);
+						++FrontierIndex;
+					}
+					if (Face.Right <= Right) {
+						NextFrontier.push_back((int)OutPolygons.size());
+						OutPolygons.push_back(VoxCore::Polygon(Face, y, z));
+						++FaceIndex;
+					}
+				}
+			}
+			while (FrontierIndex < Frontier.size()) {
+				auto& Polygon = OutPolygons[Frontier[FrontierIndex++]];
+				Polygon.CloseOff(y, z);
+			}
+			while (FaceIndex < Faces.size()) {
+				NextFrontier.push_back((int)OutPolygons.size());
+				const auto& Face = Faces[FaceIndex++];
+				OutPolygons.push_back(VoxCore::Polygon(Face, y, z));
+			}
+			Frontier.swap(NextFrontier);
+		}
+		for (auto Index : Frontier) {
+			OutPolygons[Index].CloseOff(Size[Axis::Y], z);
+		}
+	}
+
+	/**
+	 * CreateRuns
+	 * Create scan line run faces each side from run starts of visible faces
+	 * @param OutFaces Out faces
+	 * @param Count Cells of row
+	 * @param ColorRow Visible face colors of row
+	 * @param FlippedRow Visible face sides of row
+	 * @param RunStarts Storage of Count / 64 + 1 words
+	 */
+	static void CreateRuns(std::vector<Face>& OutFaces, int Count, const uint8_t* ColorRow, const uint8_t* FlippedRow, uint64_t* RunStarts)
+	{
+		VisibilityKernel::FindRunStarts(ColorRow, FlippedRow, (size_t)Count, RunStarts);
+		auto Start = -1;
+		for (auto Word = 0; Word <= Count / 64; ++Word) {
+			for (auto Bits = RunStarts[Word]; Bits != 0; Bits &= Bits - 1) {
+				const auto Index = Word * 64 + VisibilityKernel::CountTrailingZeros(Bits);
+				if (0 <= Start && ColorRow[Start] != 0) {
+					OutFaces.push_back(Face(FlippedRow[Start] ? -ColorRow[Start] : ColorRow[Start], Start, Index));
+				}
+				Start = Index;
+			}
+		}
+	}
+
+	/**
+	 * CreateFaces
+	 * Create scan line run faces each side with corner occlusion
+	 * @param OutFaces Out faces
+	 * @param y Row of faces
+	 * @param z Plane of faces
+	 * @param ColorRow Visible face colors of row
+	 * @param FlippedRow Visible face sides of row
+	 */
+	template<int Dimension>
+	void CreateFaces(std::vector<Face>& OutFaces, int y, int z, const uint8_t* ColorRow, const uint8_t* FlippedRow) const
+	{
+		typedef ScanAxis<Dimension> Axis;
+		const Int3& Size = Volume.GetSize();
+		auto PreviouseColor = 0;
+		auto PreviouseAO = 3;
+		auto x = 0;
+		for (; x < Size[Axis::X]; ++x) {
+			const int Visible = ColorRow[x];
+			auto Color = FlippedRow[x] ? -Visible : Visible;
+			auto Face = VoxCore::Face(Color, x, x);
+			if (Color != 0) {
+				//empty cell in front of face
+				const auto Cell = Volume.GetIndex(Axis::ToVolume(x, y, Color < 0 ? z : z - 1));
+				Face.CornerAO[0] = GetAmbientOcclusion<Dimension>(Cell, -1, -1);
+				Face.CornerAO[1] = GetAmbientOcclusion<Dimension>(Cell, +1, -1);
+				Face.CornerAO[2] = GetAmbientOcclusion<Dimension>(Cell, -1, +1);
+				Face.CornerAO[3] = GetAmbientOcclusion<Dimension>(Cell, +1, +1);
+				const auto Uniform = Face.CornerAO[0] == Face.CornerAO[1] && Face.CornerAO[0] == Face.CornerAO[2] && Face.CornerAO[0] == Face.CornerAO[3];
+				Face.AO = Uniform ? Face.CornerAO[0] : -1;
+			}
+			if (PreviouseColor != Color || PreviouseAO != Face.AO || Face.AO < 0) {
+				if (PreviouseColor != 0) {
+					OutFaces.back().Right = x;
+				}
+				if (Color != 0) {
+					OutFaces.push_back(Face);
+				}
+			}
+			PreviouseColor = Color;
+			PreviouseAO = Face.AO;
+		}
+		if (PreviouseColor != 0) {
+			OutFaces.back().Right = x;
+		}
+	}
+
+	/**
+	 * GetAmbientOcclusion
+	 * Count open cells around face corner, 0 if both sides are solid
+	 * @param Cell Padded index of empty cell in front of face, neighbours in plane are inside padding
+	 * @param SideX Corner direction along Axis X
+	 * @param SideY Corner direction along Axis Y
+	 */
+	template<int Dimension>
+	int GetAmbientOcclusion(size_t Cell, int SideX, int SideY) const
+	{
+		typedef ScanAxis<Dimension> Axis;
+		const Int3& Stride = Volume.GetStride();
+		const uint8_t* Cells = Volume.GetCells() + Cell;
+		const uint8_t* Occluded = Volume.GetOccluded() + Cell;
+		const ptrdiff_t DX = SideX * Stride[Axis::X], DY = SideY * Stride[Axis::Y];
+		const int Side1 = (Cells[DX] | Occluded[DX]) != 0;
+		const int Side2 = (Cells[DY] | Occluded[DY]) != 0;
+		const int Corner = (Cells[DX + DY] | Occluded[DX + DY]) != 0;
+		return Side1 && Side2 ? 0 : 3 - Side1 - Side2 - Corner;
+	}
+
+	/**
+	 * WritePolygon
+	 * Split polygon to triangle mesh
+	 * @param OutMesh Out mesh
+	 * @param Weld Index of written positions
+	 * @param Polygon Polygon to divide and write, flipped face looks toward +Axis Z
+	 */
+	template<int Dimension, bool Flipped>
+	void WritePolygon(VoxMesh& OutMesh, WeldMap& Weld, const Polygon& Polygon) const
+	{
+		typedef ScanAxis<Dimension> Axis;
+		auto LeftIndex = std::vector<uint32_t>();
+		auto RightIndex = std::vector<uint32_t>();
+		WriteVertex<Dimension>(OutMesh, Weld, LeftIndex, Polygon.Left);
+		WriteVertex<Dimension>(OutMesh, Weld, RightIndex, Polygon.Right);
+
+		const auto Color = Flipped ? -Polygon.Color - 1 : Polygon.Color - 1;
+		const auto MaterialIndex = Options.bGroupByDirection ? Axis::Direction + (Flipped ? 0 : 1) : 0;
+		size_t Left = 1, Right = 1;
+		auto LastSide = true;
+
+		const auto CrossProduct = [](const Int3& a, const Int3& b) -> int {
+			return a.X * b.Y - b.X * a.Y;
+		};
+		const auto VertexAO = [&](const Int3& Vertex) -> uint8_t {
+			if (0 <= Polygon.AO) {
+				return (uint8_t)Polygon.AO;
+			}
+			const auto& Origin = Polygon.Left[0];
+			return (uint8_t)Polygon.CornerAO[(Vertex.Y - Origin.Y) * 2 + (Vertex.X - Origin.X)];
+		};
+		uint8_t AO[3];
+		const uint8_t* WedgeAO = Options.bAmbientOcclusion ? AO : nullptr;
+		const uint32_t ChartIndex = (uint32_t)OutMesh.Charts.size();
+		const uint32_t* Chart = Options.bLightmapCharts ? &ChartIndex : nullptr;
+		if (Chart) {
+			OutMesh.Charts.push_back(GetChart<Dimension>(Polygon));
+		}
+
+		struct Entry { uint32_t Index; Int3 Vertex; };
+		auto List = std::vector<Entry>();
+		size_t Head = 0;
+		List.push_back(Entry{ LeftIndex[0], Polygon.Left[0] });
+		List.push_back(Entry{ RightIndex[0], Polygon.Right[0] });
+
+		while (Left < Polygon.Left.size() || Right < Polygon.Right.size()) {
+			auto Side = false;
+			if (Left == Polygon.Left.size()) {
+				Side = true;
+			} else if (Right != Polygon.Right.size()) {
+				const auto& L = Polygon.Left[Left];
+				const auto& R = Polygon.Right[Right];
+				Side = L.Y > R.Y;
+			}
+
+			const auto Index = Side ? RightIndex[Right] : LeftIndex[Left];
+			const auto Vertex = Side ? Polygon.Right[Right] : Polygon.Left[Left];
+			if (Side != LastSide) {
+				while (1 < List.size() - Head) {
+					const auto& First = List[Head];
+					const auto& Second = List[Head + 1];
+					//collinear on staircase sides, zero area
+					if (CrossProduct(First.Vertex - Vertex, Second.Vertex - Vertex) != 0) {
+						if (WedgeAO) {
+							AO[0] = VertexAO(First.Vertex), AO[1] = VertexAO(Second.Vertex), AO[2] = VertexAO(Vertex);
+						}
+						WriteWedge(OutMesh, Flipped == Side, First.Index, Second.Index, Index, Color, WedgeAO, MaterialIndex, Chart);
+					}
+					++Head;
+				}
+			} else {
+				while (1 < List.size() - Head) {
+					const auto& Last = List[List.size() - 1];
+					const auto& PreviousLast = List[List.size() - 2];
+					const auto Normal = CrossProduct(Last.Vertex - Vertex, PreviousLast.Vertex - Vertex);
+					if (Side == (Normal > 0)) {
+						break;
+					}
+					if (Normal != 0) {
+						if (WedgeAO) {
+							AO[0] = VertexAO(Last.Vertex), AO[1] = VertexAO(PreviousLast.Vertex), AO[2] = VertexAO(Vertex);
+						}
+						WriteWedge(OutMesh, Flipped == Side, Last.Index, PreviousLast.Index, Index, Color, WedgeAO, MaterialIndex, Chart);
+					}
+					List.pop_back();
+				}
+			}
+			List.push_back(Entry{ Index, Vertex });
+			Side ? ++Right : ++Left;
+			LastSide = Side;
+		}
+	}
+
+	/**
+	 * GetChart
+	 * Bounding rectangle of polygon, left side holds least X and right side greatest
+	 */
+	template<int Dimension>
+	static LightmapChart GetChart(const Polygon& Polygon)
+	{
+		typedef ScanAxis<Dimension> Axis;
+		auto Left = Polygon.Left[0].X, Right = Polygon.Right[0].X;
+		for (const auto& Vertex : Polygon.Left) Left = Vertex.X < Left ? Vertex.X : Left;
+		for (const auto& Vertex : Polygon.Right) Right = Right < Vertex.X ? Vertex.X : Right;
+		const auto& First = Polygon.Left.front();
+		LightmapChart Chart;
+		Chart.Origin = Axis::ToVolume(Left, First.Y, First.Z);
+		Chart.AxisU = Axis::X;
+		Chart.AxisV = Axis::Y;
+		Chart.Width = Right - Left;
+		Chart.Height = Polygon.Left.back().Y - First.Y;
+		return Chart;
+	}
+
+	/**
+	 * WriteVertex
+	 * Weld polygon side vertices into mesh positions
+	 */
+	template<int Dimension>
+	static void WriteVertex(VoxMesh& OutMesh, WeldMap& Weld, std::vector<uint32_t>& OutIndex, const std::vector<Int3>& Side)
+	{
+		typedef ScanAxis<Dimension> Axis;
+		OutIndex.reserve(Side.size());
+		for (const auto& Vector : Side) {
+			const auto Vertex = Axis::ToVolume(Vector.X, Vector.Y, Vector.Z);
+			const uint64_t Key = (uint64_t)(uint32_t)Vertex.X | ((uint64_t)(uint32_t)Vertex.Y << 21) | ((uint64_t)(uint32_t)Vertex.Z << 42);
+			const auto Result = Weld.emplace(Key, (uint32_t)OutMesh.Positions.size());
+			if (Result.second) {
+				OutMesh.Positions.push_back(Vertex);
+			}
+			OutIndex.push_back(Result.first->second);
+		}
+	}
+
+	/**
+	 * WriteWedge
+	 * @param OutMesh Out mesh
+	 * @param AO Optional corner occlusion of Index1, Index2 and Index3
+	 * @param MaterialIndex Material index of face
+	 * @param Chart Optional lightmap chart of face
+	 */
+	static void WriteWedge(VoxMesh& OutMesh, bool Face, uint32_t Index1, uint32_t Index2, uint32_t Index3, int ColorIndex, const uint8_t* AO, int MaterialIndex, const uint32_t* Chart)
+	{
+		OutMesh.Indices.push_back(Face ? Index1 : Index2);
+		OutMesh.Indices.push_back(Face ? Index2 : Index1);
+		OutMesh.Indices.push_back(Index3);
+		if (AO) {
+			OutMesh.WedgeAO.push_back(Face ? AO[0] : AO[1]);
+			OutMesh.WedgeAO.push_back(Face ? AO[1] : AO[0]);
+			OutMesh.WedgeAO.push_back(AO[2]);
+		}
+		OutMesh.Colors.push_back((uint8_t)ColorIndex);
+		OutMesh.Materials.push_back((uint8_t)MaterialIndex);
+		if (Chart) {
+			OutMesh.TriangleCharts.push_back(*Chart);
+		}
+	}
+
+private:
+
+	const VoxVolume& Volume;
+	MeshOptions Options;
+};
+
+} // namespace VoxCore
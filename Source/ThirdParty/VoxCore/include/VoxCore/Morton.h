@@ -0,0 +1,200 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+#include "VoxFile.h"
+
+namespace VoxCore
+{
+
+/**
+ * Morton
+ * Z order of cells. Cells of every aligned cube of 2^n cells are contiguous
+ * in Z order, so neighbours of a cell are mostly close in memory and time
+ * along every axis, not only along X.
+ */
+struct Morton
+{
+	/** Spread low 10 bits of value to every third bit */
+	static uint32_t Spread(uint32_t Value)
+	{
+		Value &= 0x3ff;
+		Value = (Value | (Value << 16)) & 0x030000ff;
+		Value = (Value | (Value << 8)) & 0x0300f00f;
+		Value = (Value | (Value << 4)) & 0x030c30c3;
+		Value = (Value | (Value << 2)) & 0x09249249;
+		return Value;
+	}
+
+	/** Gather every third bit to low 10 bits */
+	static uint32_t Compact(uint32_t Code)
+	{
+		Code &= 0x09249249;
+		Code = (Code | (Code >> 2)) & 0x030c30c3;
+		Code = (Code | (Code >> 4)) & 0x0300f00f;
+		Code = (Code | (Code >> 8)) & 0x030000ff;
+		Code = (Code | (Code >> 16)) & 0x000003ff;
+		return Code;
+	}
+
+	/** Z order of cell, every component 0 to 1023 */
+	static uint32_t Encode(uint32_t X, uint32_t Y, uint32_t Z)
+	{
+		return Spread(X) | (Spread(Y) << 1) | (Spread(Z) << 2);
+	}
+
+	static Int3 Decode(uint32_t Code)
+	{
+		return Int3((int32_t)Compact(Code), (int32_t)Compact(Code >> 1), (int32_t)Compact(Code >> 2));
+	}
+
+	/**
+	 * Sort cells into Z order
+	 * Duplicated cells are dropped but the last one, same as later passes
+	 * overwriting them. Dense cells are scattered into a grid indexed by code
+	 * and gathered back, sparse cells are radix sorted, both linear in cells.
+	 */
+	static void Sort(std::vector<VoxCell>& Cells)
+	{
+		if (Cells.size() < 2) return;
+		uint32_t Bits = 0;
+		for (const VoxCell& Cell : Cells) {
+			Bits |= (uint32_t)(Cell.X | Cell.Y | Cell.Z);
+		}
+		size_t NumCodes = 1;
+		for (; Bits; Bits >>= 1) NumCodes <<= 3;
+		if (NumCodes <= Cells.size() * 16) {
+			SortDense(Cells, NumCodes);
+		} else {
+			SortSparse(Cells);
+		}
+	}
+
+	/** Sort cells of every model into Z order */
+	static void Sort(VoxFile& File)
+	{
+		for (VoxModel& Model : File.Models) {
+			Sort(Model.Cells);
+		}
+	}
+
+	/**
+	 * Call Func(const Int3& Cell) for every cell of box from 0 to Size in Z order
+	 * Blocks out of box are skipped whole, box needs no power of two size.
+	 */
+	template<typename FunctionType>
+	static void ForEach(const Int3& Size, FunctionType&& Func)
+	{
+		int32_t Block = 1;
+		while (Block < Size.X || Block < Size.Y || Block < Size.Z) Block <<= 1;
+		if (0 < Size.X && 0 < Size.Y && 0 < Size.Z) {
+			ForEachBlock(Int3(), Block, Size, Func);
+		}
+	}
+
+private:
+
+	/** Spread of every byte and cell of every code in block of 8 cubed cells */
+	struct Tables
+	{
+		uint32_t Spread[256];
+		VoxCell Offsets[512];
+
+		Tables()
+		{
+			for (uint32_t i = 0; i < 256; ++i) {
+				Spread[i] = Morton::Spread(i);
+			}
+			for (uint32_t i = 0; i < 512; ++i) {
+				const Int3 Cell = Decode(i);
+				Offsets[i] = VoxCell{ (uint8_t)Cell.X, (uint8_t)Cell.Y, (uint8_t)Cell.Z, 0 };
+			}
+		}
+
+		uint32_t Encode(const VoxCell& Cell) const
+		{
+			return Spread[Cell.X] | (Spread[Cell.Y] << 1) | (Spread[Cell.Z] << 2);
+		}
+	};
+
+	static const Tables& GetTables()
+	{
+		static const Tables Instance;
+		return Instance;
+	}
+
+	static void SortDense(std::vector<VoxCell>& Cells, size_t NumCodes)
+	{
+		const Tables& Table = GetTables();
+		//color with a flag bit, zero is no cell
+		std::vector<uint16_t> Grid(NumCodes);
+		for (const VoxCell& Cell : Cells) {
+			Grid[Table.Encode(Cell)] = (uint16_t)(0x100 | Cell.I);
+		}
+		//decode once per block of 8 cubed codes, offsets in block from table
+		const size_t Step = NumCodes < 512 ? NumCodes : 512;
+		size_t NumCells = 0;
+		for (size_t Base = 0; Base < NumCodes; Base += Step) {
+			const Int3 Origin = Decode((uint32_t)Base);
+			const uint16_t* Block = Grid.data() + Base;
+			for (size_t Code = 0; Code < Step; ++Code) {
+				if (Block[Code] == 0) continue;
+				const VoxCell& Offset = Table.Offsets[Code];
+				Cells[NumCells++] = VoxCell{ (uint8_t)(Origin.X + Offset.X), (uint8_t)(Origin.Y + Offset.Y), (uint8_t)(Origin.Z + Offset.Z), (uint8_t)Block[Code] };
+			}
+		}
+		Cells.resize(NumCells);
+	}
+
+	static void SortSparse(std::vector<VoxCell>& Cells)
+	{
+		const Tables& Table = GetTables();
+		std::vector<uint32_t> Codes(Cells.size()), SortedCodes(Cells.size());
+		std::vector<VoxCell> Sorted(Cells.size());
+		for (size_t i = 0; i < Cells.size(); ++i) {
+			Codes[i] = Table.Encode(Cells[i]);
+		}
+		for (uint32_t Shift = 0; Shift < 24; Shift += 8) {
+			size_t Offset[257] = { 0, };
+			for (uint32_t Code : Codes) {
+				++Offset[((Code >> Shift) & 0xff) + 1];
+			}
+			for (size_t Digit = 1; Digit < 257; ++Digit) {
+				Offset[Digit] += Offset[Digit - 1];
+			}
+			for (size_t i = 0; i < Cells.size(); ++i) {
+				const size_t Index = Offset[(Codes[i] >> Shift) & 0xff]++;
+				SortedCodes[Index] = Codes[i];
+				Sorted[Index] = Cells[i];
+			}
+			Codes.swap(SortedCodes);
+			Cells.swap(Sorted);
+		}
+		//stable, so last of equal codes is the last in file
+		size_t NumCells = 0;
+		for (size_t i = 0; i < Cells.size(); ++i) {
+			if (i + 1 < Cells.size() && Codes[i] == Codes[i + 1]) continue;
+			Cells[NumCells++] = Cells[i];
+		}
+		Cells.resize(NumCells);
+	}
+
+	template<typename FunctionType>
+	static void ForEachBlock(const Int3& Origin, int32_t Block, const Int3& Size, FunctionType& Func)
+	{
+		if (Block == 1) {
+			Func(Origin);
+			return;
+		}
+		const int32_t Half = Block / 2;
+		for (int32_t Child = 0; Child < 8; ++Child) {
+			const Int3 ChildOrigin(Origin.X + (Child & 1) * Half, Origin.Y + ((Child >> 1) & 1) * Half, Origin.Z + ((Child >> 2) & 1) * Half);
+			if (ChildOrigin.X < Size.X && ChildOrigin.Y < Size.Y && ChildOrigin.Z < Size.Z) {
+				ForEachBlock(ChildOrigin, Half, Size, Func);
+			}
+		}
+	}
+};
+
+} // namespace VoxCore
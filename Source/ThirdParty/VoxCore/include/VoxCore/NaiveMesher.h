@@ -0,0 +1,109 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "MonotoneMesher.h"
+
+namespace VoxCore
+{
+
+/**
+ * NaiveMesher
+ * Two triangles of every visible cell face, mesher of FVox::CreateRawMesh.
+ * Slow but obviously correct, reference of optimized mesher.
+ */
+class NaiveMesher
+{
+public:
+
+	NaiveMesher(const VoxVolume& InVolume, const MeshOptions& InOptions = MeshOptions())
+		: Volume(InVolume), Options(InOptions)
+	{
+	}
+
+	/** Append mesh of every visible face */
+	void CreateMesh(VoxMesh& OutMesh) const
+	{
+		static const Int3 Vectors[6] = {
+			Int3(0, 0, 1), Int3(0, 0, -1), Int3(1, 0, 0), Int3(-1, 0, 0), Int3(0, 1, 0), Int3(0, -1, 0),
+		};
+		static const Int3 Vertexes[8] = {
+			Int3(0, 0, 0), Int3(1, 0, 0), Int3(1, 1, 0), Int3(0, 1, 0),
+			Int3(0, 0, 1), Int3(1, 0, 1), Int3(1, 1, 1), Int3(0, 1, 1),
+		};
+		static const int Faces[6][4] = {
+			{ 5, 4, 7, 6 }, { 0, 1, 2, 3 }, { 5, 6, 2, 1 }, { 7, 4, 0, 3 }, { 6, 7, 3, 2 }, { 4, 5, 1, 0 },
+		};
+		static const int Polygons[2][3] = { { 0, 1, 2 }, { 2, 3, 0 } };
+
+		const Int3& Size = Volume.GetSize();
+		std::unordered_map<uint64_t, uint32_t> Weld;
+		Int3 Cell;
+		for (Cell.Z = 0; Cell.Z < Size.Z; ++Cell.Z) {
+			for (Cell.Y = 0; Cell.Y < Size.Y; ++Cell.Y) {
+				for (Cell.X = 0; Cell.X < Size.X; ++Cell.X) {
+					const uint8_t Color = Volume.Get(Cell);
+					if (Color == 0) continue;
+					for (int FaceIndex = 0; FaceIndex < 6; ++FaceIndex) {
+						const Int3 n = Cell + Vectors[FaceIndex];
+						if (Volume.IsSolid(n)) continue;
+						uint32_t Index[4];
+						uint8_t AO[4];
+						for (int VertexIndex = 0; VertexIndex < 4; ++VertexIndex) {
+							const Int3& Corner = Vertexes[Faces[FaceIndex][VertexIndex]];
+							Index[VertexIndex] = WriteVertex(OutMesh, Weld, Cell + Corner);
+							AO[VertexIndex] = GetAmbientOcclusion(n, Vectors[FaceIndex], Corner);
+						}
+						for (int PolygonIndex = 0; PolygonIndex < 2; ++PolygonIndex) {
+							for (int Wedge = 0; Wedge < 3; ++Wedge) {
+								OutMesh.Indices.push_back(Index[Polygons[PolygonIndex][Wedge]]);
+								if (Options.bAmbientOcclusion) {
+									OutMesh.WedgeAO.push_back(AO[Polygons[PolygonIndex][Wedge]]);
+								}
+							}
+							OutMesh.Colors.push_back((uint8_t)(Color - 1));
+							OutMesh.Materials.push_back((uint8_t)(Options.bGroupByDirection ? FaceIndex : 0));
+						}
+					}
+				}
+			}
+		}
+	}
+
+private:
+
+	/** Corner occlusion of empty cell in front of face toward the corner */
+	uint8_t GetAmbientOcclusion(const Int3& Cell, const Int3& Normal, const Int3& Corner) const
+	{
+		Int3 Side[2];
+		int NumSides = 0;
+		for (int Axis = 0; Axis < 3; ++Axis) {
+			if (Normal[Axis] != 0) continue;
+			Side[NumSides] = Int3();
+			Side[NumSides++][Axis] = 0 < Corner[Axis] ? 1 : -1;
+		}
+		const int Side1 = Volume.IsSolid(Cell + Side[0]);
+		const int Side2 = Volume.IsSolid(Cell + Side[1]);
+		const int Diagonal = Volume.IsSolid(Cell + Side[0] + Side[1]);
+		return (uint8_t)(Side1 && Side2 ? 0 : 3 - Side1 - Side2 - Diagonal);
+	}
+
+	static uint32_t WriteVertex(VoxMesh& OutMesh, std::unordered_map<uint64_t, uint32_t>& Weld, const Int3& Vertex)
+	{
+		const uint64_t Key = (uint64_t)(uint32_t)Vertex.X | ((uint64_t)(uint32_t)Vertex.Y << 21) | ((uint64_t)(uint32_t)Vertex.Z << 42);
+		const auto Result = Weld.emplace(Key, (uint32_t)OutMesh.Positions.size());
+		if (Result.second) {
+			OutMesh.Positions.push_back(Vertex);
+		}
+		return Result.first->second;
+	}
+
+private:
+
+	const VoxVolume& Volume;
+	MeshOptions Options;
+};
+
+} // namespace VoxCore
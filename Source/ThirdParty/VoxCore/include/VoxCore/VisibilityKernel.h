@@ -0,0 +1,159 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VOXCORE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#include <emmintrin.h>
+#define VOXCORE_SSE2 1
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace VoxCore
+{
+
+/**
+ * VisibilityKernel
+ * Visible faces between two adjacent slices of cells, whole rows at once.
+ * Back cell face is visible if front cell is empty and not occluded, and the
+ * other way around. Instruction set is chosen at compile time, AVX2 if the
+ * compiler targets it, SSE2 on every x64 target, scalar otherwise.
+ */
+struct VisibilityKernel
+{
+	/** Bytes of slack readable past the last cell by vector loads */
+	static const size_t Padding = 32;
+
+	/**
+	 * Compute visible faces of Count cells
+	 * @param OutColor Color of visible face, 0 for none
+	 * @param OutFlipped 0xff if visible face belongs to back cell and looks toward front
+	 */
+	static void Compute(const uint8_t* Back, const uint8_t* Front, const uint8_t* BackOccluded, const uint8_t* FrontOccluded,
+		uint8_t* OutColor, uint8_t* OutFlipped, size_t Count)
+	{
+		size_t Index = 0;
+#if VOXCORE_AVX2
+		Index = ComputeAvx2(Back, Front, BackOccluded, FrontOccluded, OutColor, OutFlipped, Count);
+#elif VOXCORE_SSE2
+		Index = ComputeSse2(Back, Front, BackOccluded, FrontOccluded, OutColor, OutFlipped, Count);
+#endif
+		ComputeScalar(Back, Front, BackOccluded, FrontOccluded, OutColor, OutFlipped, Index, Count);
+	}
+
+	/** Compute cells from Index to Count one at a time, returns Count */
+	static size_t ComputeScalar(const uint8_t* Back, const uint8_t* Front, const uint8_t* BackOccluded, const uint8_t* FrontOccluded,
+		uint8_t* OutColor, uint8_t* OutFlipped, size_t Index, size_t Count)
+	{
+		for (; Index < Count; ++Index) {
+			const bool bBack = Back[Index] && !Front[Index] && !FrontOccluded[Index];
+			const bool bFront = Front[Index] && !Back[Index] && !BackOccluded[Index];
+			OutColor[Index] = bBack ? Back[Index] : bFront ? Front[Index] : 0;
+			OutFlipped[Index] = bBack ? 0xff : 0;
+		}
+		return Count;
+	}
+
+#if VOXCORE_SSE2
+	/** Compute whole 16 cell blocks, returns cells done */
+	static size_t ComputeSse2(const uint8_t* Back, const uint8_t* Front, const uint8_t* BackOccluded, const uint8_t* FrontOccluded,
+		uint8_t* OutColor, uint8_t* OutFlipped, size_t Count)
+	{
+		const __m128i Zero = _mm_setzero_si128();
+		size_t Index = 0;
+		for (; Index + 16 <= Count; Index += 16) {
+			const __m128i b = _mm_loadu_si128((const __m128i*)(Back + Index));
+			const __m128i f = _mm_loadu_si128((const __m128i*)(Front + Index));
+			const __m128i BackEmpty = _mm_cmpeq_epi8(b, Zero);
+			const __m128i FrontEmpty = _mm_cmpeq_epi8(f, Zero);
+			const __m128i BackOpen = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(BackOccluded + Index)), Zero);
+			const __m128i FrontOpen = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(FrontOccluded + Index)), Zero);
+			const __m128i BackVisible = _mm_andnot_si128(BackEmpty, _mm_and_si128(FrontEmpty, FrontOpen));
+			const __m128i FrontVisible = _mm_andnot_si128(FrontEmpty, _mm_and_si128(BackEmpty, BackOpen));
+			const __m128i Color = _mm_or_si128(_mm_and_si128(BackVisible, b), _mm_and_si128(FrontVisible, f));
+			_mm_storeu_si128((__m128i*)(OutColor + Index), Color);
+			_mm_storeu_si128((__m128i*)(OutFlipped + Index), BackVisible);
+		}
+		return Index;
+	}
+#endif
+
+#if VOXCORE_AVX2
+	/** Compute whole 32 cell blocks and remaining 16 cell block, returns cells done */
+	static size_t ComputeAvx2(const uint8_t* Back, const uint8_t* Front, const uint8_t* BackOccluded, const uint8_t* FrontOccluded,
+		uint8_t* OutColor, uint8_t* OutFlipped, size_t Count)
+	{
+		const __m256i Zero = _mm256_setzero_si256();
+		size_t Index = 0;
+		for (; Index + 32 <= Count; Index += 32) {
+			const __m256i b = _mm256_loadu_si256((const __m256i*)(Back + Index));
+			const __m256i f = _mm256_loadu_si256((const __m256i*)(Front + Index));
+			const __m256i BackEmpty = _mm256_cmpeq_epi8(b, Zero);
+			const __m256i FrontEmpty = _mm256_cmpeq_epi8(f, Zero);
+			const __m256i BackOpen = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(BackOccluded + Index)), Zero);
+			const __m256i FrontOpen = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(FrontOccluded + Index)), Zero);
+			const __m256i BackVisible = _mm256_andnot_si256(BackEmpty, _mm256_and_si256(FrontEmpty, FrontOpen));
+			const __m256i FrontVisible = _mm256_andnot_si256(FrontEmpty, _mm256_and_si256(BackEmpty, BackOpen));
+			const __m256i Color = _mm256_or_si256(_mm256_and_si256(BackVisible, b), _mm256_and_si256(FrontVisible, f));
+			_mm256_storeu_si256((__m256i*)(OutColor + Index), Color);
+			_mm256_storeu_si256((__m256i*)(OutFlipped + Index), BackVisible);
+		}
+		return Index + ComputeSse2(Back + Index, Front + Index, BackOccluded + Index, FrontOccluded + Index, OutColor + Index, OutFlipped + Index, Count - Index);
+	}
+#endif
+
+	/**
+	 * Mark cells starting a new run of color and side in a row
+	 * Bit i of OutBits is set if cell i differs from cell i - 1. Cell -1 and
+	 * Count are read and must hold no face, so the last run always ends at
+	 * bit Count. OutBits holds Count / 64 + 1 words.
+	 */
+	static void FindRunStarts(const uint8_t* Color, const uint8_t* Flipped, size_t Count, uint64_t* OutBits)
+	{
+		const size_t NumWords = Count / 64 + 1;
+		for (size_t Word = 0; Word < NumWords; ++Word) {
+			uint64_t Bits = 0;
+			const size_t Base = Word * 64;
+			size_t Offset = 0;
+#if VOXCORE_SSE2
+			for (; Offset < 64 && Base + Offset <= Count; Offset += 16) {
+				const uint8_t* c = Color + Base + Offset;
+				const uint8_t* s = Flipped + Base + Offset;
+				const __m128i Same = _mm_and_si128(
+					_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)c), _mm_loadu_si128((const __m128i*)(c - 1))),
+					_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)s), _mm_loadu_si128((const __m128i*)(s - 1))));
+				Bits |= (uint64_t)(uint16_t)~_mm_movemask_epi8(Same) << Offset;
+			}
+#else
+			for (; Offset < 64 && Base + Offset <= Count; ++Offset) {
+				const size_t Index = Base + Offset;
+				Bits |= (uint64_t)(Color[Index] != Color[Index - 1] || Flipped[Index] != Flipped[Index - 1]) << Offset;
+			}
+#endif
+			//drop bits past Count
+			const size_t Valid = Count + 1 - Base;
+			OutBits[Word] = Valid < 64 ? Bits & ((uint64_t(1) << Valid) - 1) : Bits;
+		}
+	}
+
+	/** Index of lowest set bit, Bits must not be 0 */
+	static int CountTrailingZeros(uint64_t Bits)
+	{
+#if defined(_MSC_VER)
+		unsigned long Index;
+		_BitScanForward64(&Index, Bits);
+		return (int)Index;
+#else
+		return __builtin_ctzll(Bits);
+#endif
+	}
+};
+
+} // namespace VoxCore
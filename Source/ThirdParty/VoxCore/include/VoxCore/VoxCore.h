@@ -0,0 +1,18 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+/**
+ * VoxCore
+ * Engine independent vox parsing, voxel storage and meshing. Editor module
+ * adapts it to unreal types, bench tool builds it standalone.
+ */
+#include "VoxTypes.h"
+#include "VoxFile.h"
+#include "Morton.h"
+#include "VoxWriter.h"
+#include "VoxVolume.h"
+#include "MonotoneMesher.h"
+#include "NaiveMesher.h"
+#include "LightmapPacker.h"
+#include "DistanceField.h"
@@ -0,0 +1,190 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+#include "VoxTypes.h"
+
+namespace VoxCore
+{
+
+/**
+ * @struct VoxCell
+ * Cell of XYZI chunk in vox axes.
+ */
+struct VoxCell
+{
+	uint8_t X, Y, Z, I;
+};
+
+/**
+ * @struct VoxModel
+ * Model of SIZE and XYZI chunk pair.
+ */
+struct VoxModel
+{
+	/** Size in vox axes */
+	Int3 Size;
+	/** Cells in file order */
+	std::vector<VoxCell> Cells;
+};
+
+/**
+ * @struct VoxChunk
+ * Chunk not handled by reader, contents refer to read buffer.
+ */
+struct VoxChunk
+{
+	/** Chunk id, not terminated */
+	char Id[4];
+	/** Chunk contents */
+	const uint8_t* Data;
+	/** Size of chunk contents */
+	uint32_t Size;
+
+	bool Is(const char* InId) const { return 0 == std::memcmp(Id, InId, 4); }
+};
+
+/** Result of reading vox data */
+enum class VoxError
+{
+	None,
+	NotVox,
+	UnsupportedVersion,
+	Truncated,
+	/** Model size out of 1 to MaxModelSize on any axis */
+	InvalidSize,
+};
+
+/**
+ * @struct VoxFile
+ * Models and palette of vox data.
+ * @see https://github.com/ephtracy/voxel-model/blob/master/MagicaVoxel-file-format-vox.txt
+ */
+struct VoxFile
+{
+	/** Version number ( current version is 150 ) */
+	uint32_t Version;
+	/** Models in file order */
+	std::vector<VoxModel> Models;
+	/** RGBA chunk contents, empty for default palette */
+	std::vector<Color> Palette;
+
+	VoxFile() : Version(0) { }
+
+	/** Number of cells of every model */
+	size_t GetNumCells() const
+	{
+		size_t Result = 0;
+		for (const VoxModel& Model : Models) {
+			Result += Model.Cells.size();
+		}
+		return Result;
+	}
+};
+
+/**
+ * VoxReader
+ * Read vox data from memory. SIZE, XYZI and RGBA chunks are read to file,
+ * MAIN children are walked and any other chunk is passed to callback.
+ */
+class VoxReader
+{
+public:
+
+	/** Largest model size on every axis, cell coordinates are one byte */
+	static const int32_t MaxModelSize = 256;
+
+	VoxReader(const uint8_t* InData, size_t InSize)
+		: Data(InData), Size(InSize), Position(0)
+	{
+	}
+
+	/** Read vox data and pass unhandled chunk to OnChunk(const VoxChunk&) */
+	template<typename ChunkFunc>
+	VoxError Read(VoxFile& OutFile, ChunkFunc&& OnChunk)
+	{
+		if (!Has(8)) return VoxError::NotVox;
+		if (0 != std::memcmp(Data, "VOX ", 4)) return VoxError::NotVox;
+		Position = 4;
+		OutFile.Version = ReadUInt32();
+		if (150 < OutFile.Version) return VoxError::UnsupportedVersion;
+
+		while (Position < Size) {
+			if (!Has(12)) return VoxError::Truncated;
+			VoxChunk Chunk;
+			std::memcpy(Chunk.Id, Data + Position, 4);
+			Position += 4;
+			Chunk.Size = ReadUInt32();
+			const uint32_t SizeOfChildren = ReadUInt32();
+			(void)SizeOfChildren;
+			if (!Has(Chunk.Size)) return VoxError::Truncated;
+			Chunk.Data = Data + Position;
+			if (Chunk.Is("MAIN")) {
+				//children follow contents
+			} else if (Chunk.Is("SIZE")) {
+				if (Chunk.Size < 12) return VoxError::Truncated;
+				VoxModel Model;
+				Model.Size.X = ReadInt32(Chunk.Data + 0);
+				Model.Size.Y = ReadInt32(Chunk.Data + 4);
+				Model.Size.Z = ReadInt32(Chunk.Data + 8);
+				//dense volumes are allocated from size, so reject it before anything else
+				if (!IsValidSize(Model.Size.X) || !IsValidSize(Model.Size.Y) || !IsValidSize(Model.Size.Z)) return VoxError::InvalidSize;
+				OutFile.Models.push_back(Model);
+			} else if (Chunk.Is("XYZI")) {
+				if (Chunk.Size < 4 || OutFile.Models.empty()) return VoxError::Truncated;
+				const uint32_t NumCells = ReadUInt32(Chunk.Data);
+				if ((Chunk.Size - 4) / 4 < NumCells) return VoxError::Truncated;
+				std::vector<VoxCell>& Cells = OutFile.Models.back().Cells;
+				Cells.resize(NumCells);
+				if (NumCells) std::memcpy(Cells.data(), Chunk.Data + 4, NumCells * sizeof(VoxCell));
+			} else if (Chunk.Is("RGBA")) {
+				OutFile.Palette.resize(Chunk.Size / 4);
+				if (!OutFile.Palette.empty()) std::memcpy(OutFile.Palette.data(), Chunk.Data, OutFile.Palette.size() * sizeof(Color));
+			} else {
+				OnChunk(Chunk);
+			}
+			Position += Chunk.Size;
+		}
+		return VoxError::None;
+	}
+
+	/** Read vox data and skip unhandled chunks */
+	VoxError Read(VoxFile& OutFile)
+	{
+		return Read(OutFile, [](const VoxChunk&) { });
+	}
+
+	/** Read little endian integer */
+	static uint32_t ReadUInt32(const uint8_t* Bytes)
+	{
+		return (uint32_t)Bytes[0] | ((uint32_t)Bytes[1] << 8) | ((uint32_t)Bytes[2] << 16) | ((uint32_t)Bytes[3] << 24);
+	}
+
+	static int32_t ReadInt32(const uint8_t* Bytes)
+	{
+		return (int32_t)ReadUInt32(Bytes);
+	}
+
+private:
+
+	bool Has(size_t Count) const { return Count <= Size - Position; }
+
+	static bool IsValidSize(int32_t Value) { return 1 <= Value && Value <= MaxModelSize; }
+
+	uint32_t ReadUInt32()
+	{
+		const uint32_t Result = ReadUInt32(Data + Position);
+		Position += 4;
+		return Result;
+	}
+
+private:
+
+	const uint8_t* Data;
+	size_t Size;
+	size_t Position;
+};
+
+} // namespace VoxCore
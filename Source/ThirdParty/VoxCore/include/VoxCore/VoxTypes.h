@@ -0,0 +1,40 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VoxCore
+{
+
+/**
+ * @struct Int3
+ * Integer vector of cell and vertex coordinates.
+ */
+struct Int3
+{
+	int32_t X, Y, Z;
+
+	Int3() : X(0), Y(0), Z(0) { }
+	Int3(int32_t InX, int32_t InY, int32_t InZ) : X(InX), Y(InY), Z(InZ) { }
+
+	int32_t& operator[](int32_t Index) { return (&X)[Index]; }
+	int32_t operator[](int32_t Index) const { return (&X)[Index]; }
+
+	Int3 operator+(const Int3& Other) const { return Int3(X + Other.X, Y + Other.Y, Z + Other.Z); }
+	Int3 operator-(const Int3& Other) const { return Int3(X - Other.X, Y - Other.Y, Z - Other.Z); }
+	bool operator==(const Int3& Other) const { return X == Other.X && Y == Other.Y && Z == Other.Z; }
+	bool operator!=(const Int3& Other) const { return !(*this == Other); }
+};
+
+/**
+ * @struct Color
+ * Palette entry in file order.
+ */
+struct Color
+{
+	uint8_t R, G, B, A;
+};
+
+} // namespace VoxCore
@@ -0,0 +1,86 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+#include "VoxTypes.h"
+
+namespace VoxCore
+{
+
+/**
+ * VoxVolume
+ * Dense cells of model with one cell of padding around, so neighbours of
+ * every face and corner are read without bounds checks by mesher. Occluded
+ * marks empty cells counted as solid, filled by adjacent models or enclosed.
+ */
+class VoxVolume
+{
+public:
+
+	explicit VoxVolume(const Int3& InSize)
+		: Size(InSize)
+		, Stride(1, InSize.X + 2, (InSize.X + 2) * (InSize.Y + 2))
+		, Cells((size_t)Stride.Z * (InSize.Z + 2), 0)
+		, Occluded(Cells.size(), 0)
+	{
+	}
+
+	const Int3& GetSize() const { return Size; }
+
+	/** Color index of cell, 0 for empty or outside of padding */
+	uint8_t Get(const Int3& Cell) const
+	{
+		return IsPadded(Cell) ? Cells[GetIndex(Cell)] : 0;
+	}
+
+	void Set(const Int3& Cell, uint8_t Value)
+	{
+		if (IsPadded(Cell)) Cells[GetIndex(Cell)] = Value;
+	}
+
+	bool IsOccluded(const Int3& Cell) const
+	{
+		return IsPadded(Cell) && Occluded[GetIndex(Cell)] != 0;
+	}
+
+	void SetOccluded(const Int3& Cell, bool bOccluded)
+	{
+		if (IsPadded(Cell)) Occluded[GetIndex(Cell)] = bOccluded ? 1 : 0;
+	}
+
+	/** Filled or occluded, used for corner occlusion */
+	bool IsSolid(const Int3& Cell) const
+	{
+		if (!IsPadded(Cell)) return false;
+		const size_t Index = GetIndex(Cell);
+		return Cells[Index] != 0 || Occluded[Index] != 0;
+	}
+
+	/** Cell inside model or its padding */
+	bool IsPadded(const Int3& Cell) const
+	{
+		return -1 <= Cell.X && Cell.X <= Size.X && -1 <= Cell.Y && Cell.Y <= Size.Y && -1 <= Cell.Z && Cell.Z <= Size.Z;
+	}
+
+	/** Index of padded cell, stride along axis is Stride[Axis] */
+	size_t GetIndex(const Int3& Cell) const
+	{
+		return (size_t)(Cell.X + 1) + (size_t)(Cell.Y + 1) * Stride.Y + (size_t)(Cell.Z + 1) * Stride.Z;
+	}
+
+	const Int3& GetStride() const { return Stride; }
+
+	const uint8_t* GetCells() const { return Cells.data(); }
+
+	const uint8_t* GetOccluded() const { return Occluded.data(); }
+
+private:
+
+	Int3 Size;
+	Int3 Stride;
+	std::vector<uint8_t> Cells;
+	std::vector<uint8_t> Occluded;
+};
+
+} // namespace VoxCore
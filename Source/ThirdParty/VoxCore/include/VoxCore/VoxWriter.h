@@ -0,0 +1,146 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "VoxFile.h"
+
+namespace VoxCore
+{
+
+/**
+ * VoxWriter
+ * Write vox data to memory. Chunks are written as children of MAIN in call
+ * order, MagicaVoxel writes models, scene graph and palette in that order.
+ */
+class VoxWriter
+{
+public:
+
+	typedef std::vector<std::pair<std::string, std::string>> Dictionary;
+
+	/** Write SIZE and XYZI chunks of model */
+	void WriteModel(const VoxModel& Model)
+	{
+		std::vector<uint8_t> Contents;
+		AppendInt32(Contents, Model.Size.X);
+		AppendInt32(Contents, Model.Size.Y);
+		AppendInt32(Contents, Model.Size.Z);
+		WriteChunk("SIZE", Contents);
+		Contents.clear();
+		AppendInt32(Contents, (int32_t)Model.Cells.size());
+		const uint8_t* Cells = reinterpret_cast<const uint8_t*>(Model.Cells.data());
+		Contents.insert(Contents.end(), Cells, Cells + Model.Cells.size() * sizeof(VoxCell));
+		WriteChunk("XYZI", Contents);
+	}
+
+	/** Write RGBA chunk, palette is padded to 256 colors */
+	void WritePalette(const std::vector<Color>& Palette)
+	{
+		std::vector<uint8_t> Contents(256 * sizeof(Color), 0);
+		for (size_t i = 0; i < Palette.size() && i < 256; ++i) {
+			Contents[i * 4 + 0] = Palette[i].R;
+			Contents[i * 4 + 1] = Palette[i].G;
+			Contents[i * 4 + 2] = Palette[i].B;
+			Contents[i * 4 + 3] = Palette[i].A;
+		}
+		WriteChunk("RGBA", Contents);
+	}
+
+	/** Write nTRN chunk of single frame with translation */
+	void WriteTransformNode(int32_t NodeId, int32_t ChildId, const Int3& Translation, const Dictionary& Attributes = Dictionary())
+	{
+		std::vector<uint8_t> Contents;
+		AppendInt32(Contents, NodeId);
+		AppendDictionary(Contents, Attributes);
+		AppendInt32(Contents, ChildId);
+		AppendInt32(Contents, -1);
+		AppendInt32(Contents, 0);
+		AppendInt32(Contents, 1);
+		Dictionary Frame;
+		if (Translation != Int3()) {
+			Frame.push_back(std::make_pair(std::string("_t"), std::to_string(Translation.X) + " " + std::to_string(Translation.Y) + " " + std::to_string(Translation.Z)));
+		}
+		AppendDictionary(Contents, Frame);
+		WriteChunk("nTRN", Contents);
+	}
+
+	/** Write nGRP chunk */
+	void WriteGroupNode(int32_t NodeId, const std::vector<int32_t>& ChildIds)
+	{
+		std::vector<uint8_t> Contents;
+		AppendInt32(Contents, NodeId);
+		AppendDictionary(Contents, Dictionary());
+		AppendInt32(Contents, (int32_t)ChildIds.size());
+		for (int32_t Child : ChildIds) {
+			AppendInt32(Contents, Child);
+		}
+		WriteChunk("nGRP", Contents);
+	}
+
+	/** Write nSHP chunk of single model */
+	void WriteShapeNode(int32_t NodeId, int32_t ModelId)
+	{
+		std::vector<uint8_t> Contents;
+		AppendInt32(Contents, NodeId);
+		AppendDictionary(Contents, Dictionary());
+		AppendInt32(Contents, 1);
+		AppendInt32(Contents, ModelId);
+		AppendDictionary(Contents, Dictionary());
+		WriteChunk("nSHP", Contents);
+	}
+
+	/** Write chunk without children */
+	void WriteChunk(const char* Id, const std::vector<uint8_t>& Contents)
+	{
+		Children.insert(Children.end(), Id, Id + 4);
+		AppendInt32(Children, (int32_t)Contents.size());
+		AppendInt32(Children, 0);
+		Children.insert(Children.end(), Contents.begin(), Contents.end());
+	}
+
+	/** Vox data of written chunks */
+	std::vector<uint8_t> GetData(uint32_t Version = 150) const
+	{
+		std::vector<uint8_t> Result = { 'V', 'O', 'X', ' ' };
+		AppendInt32(Result, (int32_t)Version);
+		Result.insert(Result.end(), { 'M', 'A', 'I', 'N' });
+		AppendInt32(Result, 0);
+		AppendInt32(Result, (int32_t)Children.size());
+		Result.insert(Result.end(), Children.begin(), Children.end());
+		return Result;
+	}
+
+	/** Append little endian integer */
+	static void AppendInt32(std::vector<uint8_t>& Out, int32_t Value)
+	{
+		const uint32_t Bits = (uint32_t)Value;
+		Out.push_back((uint8_t)(Bits));
+		Out.push_back((uint8_t)(Bits >> 8));
+		Out.push_back((uint8_t)(Bits >> 16));
+		Out.push_back((uint8_t)(Bits >> 24));
+	}
+
+	static void AppendString(std::vector<uint8_t>& Out, const std::string& Value)
+	{
+		AppendInt32(Out, (int32_t)Value.size());
+		Out.insert(Out.end(), Value.begin(), Value.end());
+	}
+
+	static void AppendDictionary(std::vector<uint8_t>& Out, const Dictionary& Value)
+	{
+		AppendInt32(Out, (int32_t)Value.size());
+		for (const auto& Pair : Value) {
+			AppendString(Out, Pair.first);
+			AppendString(Out, Pair.second);
+		}
+	}
+
+private:
+
+	std::vector<uint8_t> Children;
+};
+
+} // namespace VoxCore
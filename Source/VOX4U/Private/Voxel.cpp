@@ -2,6 +2,16 @@
 
 #include "Voxel.h"
 #include <Engine/StaticMesh.h>
+#include <Misc/Compression.h>
+#include <Serialization/CustomVersion.h>
+#include <Serialization/MemoryReader.h>
+#include <Serialization/MemoryWriter.h>
+#include "VoxelCustomVersion.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVoxel, Log, All)
+
+const FGuid FVoxelCustomVersion::GUID(0x6A3C1F52, 0x9B7E4D08, 0xA41C2E95, 0x3F80D617);
+static FCustomVersionRegistration GRegisterVoxelCustomVersion(FVoxelCustomVersion::GUID, FVoxelCustomVersion::LatestVersion, TEXT("VoxelVer"));
 
 UVoxel::UVoxel()
 	: Size(ForceInit)
@@ -9,19 +19,188 @@ UVoxel::UVoxel()
 	, bXYCenter(true)
 	, Mesh()
 	, Voxel()
+	, Grid(MakeShared<FVoxelGrid, ESPMode::ThreadSafe>())
+{
+}
+
+/**
+ * Serialize
+ * Cells of persistent archive are saved from flat grid by SerializeCells
+ * instead of tagged property serialization, and loaded into grid without
+ * map. Old packages still load cells from property tag. Cooked packages save
+ * flat grid only and load it in place.
+ */
+void UVoxel::Serialize(FArchive& Ar)
+{
+	Ar.UsingCustomVersion(FVoxelCustomVersion::GUID);
+	const bool bCompactCells = Ar.IsPersistent() && !Ar.IsTransacting()
+		&& (Ar.IsSaving() || FVoxelCustomVersion::CompactCells <= Ar.CustomVer(FVoxelCustomVersion::GUID));
+	if (bCompactCells && Ar.IsSaving()) {
+		//empty map equals to default and tagged serialization skips it
+		TMap<FIntVector, uint8> Cells = MoveTemp(Voxel);
+		Voxel.Reset();
+		Super::Serialize(Ar);
+		Voxel = MoveTemp(Cells);
+	} else {
+		Super::Serialize(Ar);
+	}
+	if (bCompactCells) {
+		bool bFlatGrid = Ar.IsSaving() && Ar.IsCooking();
+		if (FVoxelCustomVersion::FlatGrid <= Ar.CustomVer(FVoxelCustomVersion::GUID)) {
+			Ar << bFlatGrid;
+		}
+		if (bFlatGrid) {
+			Ar << *Grid;
+		} else {
+			SerializeCells(Ar);
+		}
+	}
+}
+
+void UVoxel::PostLoad()
+{
+	Super::PostLoad();
+	if (Voxel.Num()) {
+		BuildGrid();
+	}
+}
+
+void UVoxel::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Grid->GetAllocatedSize() + Voxel.GetAllocatedSize());
+}
+
+void UVoxel::BuildGrid()
+{
+	Grid = MakeShared<FVoxelGrid, ESPMode::ThreadSafe>(Voxel);
+}
+
+void UVoxel::BuildCellMap()
+{
+	if (Voxel.Num() == Grid->Num()) return;
+	Voxel.Reset();
+	Voxel.Reserve(Grid->Num());
+	Grid->ForEach([&](const FIntVector& Cell, uint8 Value) {
+		Voxel.Add(Cell, Value);
+	});
+}
+
+/**
+ * SerializeCells
+ * Runs are written from and read straight into flat grid, cell map is left
+ * empty on load.
+ * int32		: num of cells
+ * FIntVector	: min of cell bounds
+ * FIntVector	: extent of cell bounds
+ * int32		: uncompressed size
+ * int32		: compressed size, 0 if stored uncompressed
+ * uint8 x N	: runs of (uint8 value + 1 or 0 for empty, packed int32 count)
+ *				  in x, y, z order over cell bounds
+ */
+void UVoxel::SerializeCells(FArchive& Ar)
 {
+	int32 NumCells = Grid->Num();
+	FIntVector Min = Grid->GetMin(), Extent = Grid->GetExtent();
+	TArray<uint8> Runs;
+	int32 UncompressedSize = 0, CompressedSize = 0;
+	if (Ar.IsSaving()) {
+		FMemoryWriter Writer(Runs);
+		uint8 RunValue = 0;
+		uint32 RunLength = 0;
+		auto WriteRun = [&]() {
+			if (RunLength) {
+				Writer << RunValue;
+				Writer.SerializeIntPacked(RunLength);
+			}
+		};
+		for (uint8 CellValue : Grid->GetCells()) {
+			if (CellValue != RunValue) {
+				WriteRun();
+				RunValue = CellValue, RunLength = 0;
+			}
+			++RunLength;
+		}
+		WriteRun();
+		UncompressedSize = Runs.Num();
+		TArray<uint8> Compressed;
+		CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, UncompressedSize);
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (0 < UncompressedSize && FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Runs.GetData(), UncompressedSize) && CompressedSize < UncompressedSize) {
+			Compressed.SetNum(CompressedSize);
+			Runs = MoveTemp(Compressed);
+		} else {
+			CompressedSize = 0;
+		}
+	}
+
+	Ar << NumCells << Min << Extent << UncompressedSize << CompressedSize;
+	if (Ar.IsLoading()) {
+		Runs.SetNumUninitialized(CompressedSize ? CompressedSize : UncompressedSize);
+	}
+	Ar.Serialize(Runs.GetData(), Runs.Num());
+
+	if (Ar.IsLoading()) {
+		if (CompressedSize) {
+			TArray<uint8> Uncompressed;
+			Uncompressed.SetNumUninitialized(UncompressedSize);
+			if (!FCompression::UncompressMemory(NAME_Zlib, Uncompressed.GetData(), UncompressedSize, Runs.GetData(), CompressedSize)) {
+				UE_LOG(LogVoxel, Error, TEXT("%s: Failed to uncompress cells."), *GetPathName());
+				return;
+			}
+			Runs = MoveTemp(Uncompressed);
+		}
+		//runs are the flat grid values already, one memset each
+		const int64 Volume = (int64)FMath::Max(Extent.X, 0) * FMath::Max(Extent.Y, 0) * FMath::Max(Extent.Z, 0);
+		if (MAX_int32 < Volume) {
+			UE_LOG(LogVoxel, Error, TEXT("%s: Invalid cell bounds."), *GetPathName());
+			return;
+		}
+		TArray<uint8> Cells;
+		Cells.SetNumZeroed((int32)Volume);
+		FMemoryReader Reader(Runs);
+		int32 Index = 0;
+		while (!Reader.AtEnd() && !Reader.IsError() && Index < Cells.Num()) {
+			uint8 RunValue;
+			uint32 RunLength;
+			Reader << RunValue;
+			Reader.SerializeIntPacked(RunLength);
+			const int32 Count = (int32)FMath::Min<int64>(RunLength, Cells.Num() - Index);
+			if (RunValue) {
+				FMemory::Memset(Cells.GetData() + Index, RunValue, Count);
+			}
+			Index += Count;
+		}
+		Voxel.Reset();
+		Grid = MakeShared<FVoxelGrid, ESPMode::ThreadSafe>(Min, Extent, MoveTemp(Cells));
+	}
 }
 
 #if WITH_EDITOR
 
+void UVoxel::PreEditChange(UProperty* PropertyAboutToChange)
+{
+	static const FName NAME_Voxel = FName(TEXT("Voxel"));
+	//map is empty after load, edit would drop every cell from grid, filled
+	//before super records object for undo
+	if (PropertyAboutToChange && PropertyAboutToChange->GetFName() == NAME_Voxel) {
+		BuildCellMap();
+	}
+	Super::PreEditChange(PropertyAboutToChange);
+}
+
 void UVoxel::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
 {
 	static const FName NAME_Mesh = FName(TEXT("Mesh"));
+	static const FName NAME_Voxel = FName(TEXT("Voxel"));
 	if (PropertyChangedEvent.Property) {
 		if (PropertyChangedEvent.Property->GetFName() == NAME_Mesh) {
 			CalcCellBounds();
 		}
 	}
+	if (PropertyChangedEvent.MemberProperty && PropertyChangedEvent.MemberProperty->GetFName() == NAME_Voxel) {
+		BuildGrid();
+	}
 }
 
 void UVoxel::CalcCellBounds()
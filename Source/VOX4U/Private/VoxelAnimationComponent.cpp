@@ -0,0 +1,108 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxelAnimationComponent.h"
+#include <Engine/StaticMesh.h>
+#include "VoxelSectionSceneProxy.h"
+
+/**
+ * Scene proxy draws the section of current frame only. Frame changes are
+ * sent to render thread and only select other range of shared index buffer.
+ */
+class FVoxelAnimationSceneProxy : public FVoxelSectionSceneProxy
+{
+public:
+
+	FVoxelAnimationSceneProxy(UVoxelAnimationComponent* Component, int32 InFrame)
+		: FVoxelSectionSceneProxy(Component)
+		, Frame(InFrame)
+	{
+	}
+
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	void SetFrame_RenderThread(int32 InFrame)
+	{
+		check(IsInRenderingThread());
+		Frame = InFrame;
+	}
+
+protected:
+
+	virtual bool IsSectionVisible(const FSceneView* View, int32 MaterialIndex) const override
+	{
+		return MaterialIndex == Frame;
+	}
+
+private:
+
+	int32 Frame;
+};
+
+UVoxelAnimationComponent::UVoxelAnimationComponent()
+	: FramesPerSecond(10.f)
+	, bPlaying(true)
+	, Frame(0)
+	, Time(0.f)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	bTickInEditor = false;
+}
+
+void UVoxelAnimationComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	const int32 NumFrames = GetNumFrames();
+	if (bPlaying && 1 < NumFrames && 0.f < FramesPerSecond) {
+		Time = FMath::Fmod(Time + DeltaTime, (float)NumFrames / FramesPerSecond);
+		SetFrame(FMath::FloorToInt(Time * FramesPerSecond));
+	}
+}
+
+FPrimitiveSceneProxy* UVoxelAnimationComponent::CreateSceneProxy()
+{
+	UStaticMesh* Mesh = GetStaticMesh();
+	if (!Mesh || !Mesh->RenderData || Mesh->RenderData->LODResources.Num() == 0 || !Mesh->RenderData->IsInitialized()) {
+		return nullptr;
+	}
+	return new FVoxelAnimationSceneProxy(this, Frame);
+}
+
+void UVoxelAnimationComponent::SetFrame(int32 InFrame)
+{
+	const int32 NumFrames = GetNumFrames();
+	const int32 NewFrame = 0 < NumFrames ? ((InFrame % NumFrames) + NumFrames) % NumFrames : 0;
+	if (Frame == NewFrame) return;
+	Frame = NewFrame;
+	if (SceneProxy) {
+		FVoxelAnimationSceneProxy* Proxy = static_cast<FVoxelAnimationSceneProxy*>(SceneProxy);
+		ENQUEUE_RENDER_COMMAND(SetVoxelAnimationFrame)(
+			[Proxy, NewFrame](FRHICommandListImmediate& RHICmdList) {
+				Proxy->SetFrame_RenderThread(NewFrame);
+			});
+	}
+}
+
+int32 UVoxelAnimationComponent::GetFrame() const
+{
+	return Frame;
+}
+
+int32 UVoxelAnimationComponent::GetNumFrames() const
+{
+	const UStaticMesh* Mesh = GetStaticMesh();
+	return Mesh ? Mesh->StaticMaterials.Num() : 0;
+}
+
+void UVoxelAnimationComponent::Play()
+{
+	bPlaying = true;
+}
+
+void UVoxelAnimationComponent::Stop()
+{
+	bPlaying = false;
+}
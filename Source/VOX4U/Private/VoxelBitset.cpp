@@ -0,0 +1,210 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxelBitset.h"
+
+namespace
+{
+
+/** Result of every boolean operation on words, changed bits are Old ^ Result */
+struct FUnionOp
+{
+	static uint64 Apply(uint64 Old, uint64 Brush) { return Old | Brush; }
+	static VectorRegisterInt Apply(const VectorRegisterInt& Old, const VectorRegisterInt& Brush) { return VectorIntOr(Old, Brush); }
+};
+
+struct FSubtractOp
+{
+	static uint64 Apply(uint64 Old, uint64 Brush) { return Old & ~Brush; }
+	static VectorRegisterInt Apply(const VectorRegisterInt& Old, const VectorRegisterInt& Brush) { return VectorIntAndNot(Brush, Old); }
+};
+
+struct FIntersectOp
+{
+	static uint64 Apply(uint64 Old, uint64 Brush) { return Old & Brush; }
+	static VectorRegisterInt Apply(const VectorRegisterInt& Old, const VectorRegisterInt& Brush) { return VectorIntAnd(Old, Brush); }
+};
+
+} // namespace
+
+FVoxelBitset::FVoxelBitset()
+	: Min(ForceInitToZero)
+	, Extent(ForceInitToZero)
+	, WordsPerRow(0)
+	, BoundsMin(MAX_int32)
+	, BoundsMax(MIN_int32)
+	, Words()
+{
+}
+
+FVoxelBitset::FVoxelBitset(const FIntVector& InMin, const FIntVector& InExtent)
+	: FVoxelBitset()
+{
+	Init(InMin, InExtent);
+}
+
+void FVoxelBitset::Init(const FIntVector& InMin, const FIntVector& InExtent)
+{
+	if (Min == InMin && Extent == InExtent) {
+		Reset();
+		return;
+	}
+	Min = InMin;
+	Extent = FIntVector(FMath::Max(InExtent.X, 0), FMath::Max(InExtent.Y, 0), FMath::Max(InExtent.Z, 0));
+	WordsPerRow = (Extent.X + 63) >> 6;
+	BoundsMin = FIntVector(MAX_int32);
+	BoundsMax = FIntVector(MIN_int32);
+	//reset keeps storage of larger box
+	Words.Reset();
+	Words.AddZeroed(WordsPerRow * Extent.Y * Extent.Z);
+}
+
+void FVoxelBitset::Reset()
+{
+	if (IsEmpty()) return;
+	const int32 FirstWord = BoundsMin.X >> 6, NumWords = (BoundsMax.X >> 6) - FirstWord + 1;
+	for (int32 Z = BoundsMin.Z; Z <= BoundsMax.Z; ++Z) {
+		for (int32 Y = BoundsMin.Y; Y <= BoundsMax.Y; ++Y) {
+			FMemory::Memzero(Words.GetData() + GetRow(Y, Z) + FirstWord, NumWords * sizeof(uint64));
+		}
+	}
+	BoundsMin = FIntVector(MAX_int32);
+	BoundsMax = FIntVector(MIN_int32);
+}
+
+void FVoxelBitset::Set(const FIntVector& Cell, bool bValue /*= true*/)
+{
+	if (!IsInside(Cell)) return;
+	const FIntVector P = Cell - Min;
+	uint64& Word = Words[GetRow(P.Y, P.Z) + (P.X >> 6)];
+	const uint64 Bit = 1ull << (P.X & 63);
+	if (bValue) {
+		Word |= Bit;
+		AddBounds(P, P);
+	} else {
+		Word &= ~Bit;
+	}
+}
+
+/**
+ * SetSphere
+ * Every row is one span, so cells are set a word at a time.
+ * @param Center Sphere center in cell coordinate
+ * @param Radius Sphere radius in cells
+ */
+void FVoxelBitset::SetSphere(const FVector& Center, float Radius)
+{
+	if (Radius < 0.f) return;
+	const FVector C = Center - FVector(Min);
+	const int32 Z0 = FMath::Max(FMath::CeilToInt(C.Z - Radius), 0), Z1 = FMath::Min(FMath::FloorToInt(C.Z + Radius), Extent.Z - 1);
+	const int32 Y0 = FMath::Max(FMath::CeilToInt(C.Y - Radius), 0), Y1 = FMath::Min(FMath::FloorToInt(C.Y + Radius), Extent.Y - 1);
+	for (int32 Z = Z0; Z <= Z1; ++Z) {
+		for (int32 Y = Y0; Y <= Y1; ++Y) {
+			const float SquaredHalf = Radius * Radius - FMath::Square((float)Z - C.Z) - FMath::Square((float)Y - C.Y);
+			if (SquaredHalf < 0.f) continue;
+			const float Half = FMath::Sqrt(SquaredHalf);
+			SetSpan(FMath::CeilToInt(C.X - Half), FMath::FloorToInt(C.X + Half), Y, Z);
+		}
+	}
+}
+
+void FVoxelBitset::SetBox(const FIntVector& BoxMin, const FIntVector& BoxMax)
+{
+	const FIntVector P0 = BoxMin - Min, P1 = BoxMax - Min;
+	const int32 Z0 = FMath::Max(P0.Z, 0), Z1 = FMath::Min(P1.Z, Extent.Z - 1);
+	const int32 Y0 = FMath::Max(P0.Y, 0), Y1 = FMath::Min(P1.Y, Extent.Y - 1);
+	for (int32 Z = Z0; Z <= Z1; ++Z) {
+		for (int32 Y = Y0; Y <= Y1; ++Y) {
+			SetSpan(P0.X, P1.X, Y, Z);
+		}
+	}
+}
+
+void FVoxelBitset::Union(const FVoxelBitset& Brush, FVoxelBitset& OutChanged)
+{
+	//cells can only be set inside brush
+	Combine<FUnionOp>(Brush, OutChanged, Brush.BoundsMin, Brush.BoundsMax);
+	if (!OutChanged.IsEmpty()) {
+		AddBounds(OutChanged.BoundsMin, OutChanged.BoundsMax);
+	}
+}
+
+void FVoxelBitset::Subtract(const FVoxelBitset& Brush, FVoxelBitset& OutChanged)
+{
+	//cells can only be cleared inside both bounds
+	const FIntVector From(FMath::Max(BoundsMin.X, Brush.BoundsMin.X), FMath::Max(BoundsMin.Y, Brush.BoundsMin.Y), FMath::Max(BoundsMin.Z, Brush.BoundsMin.Z));
+	const FIntVector To(FMath::Min(BoundsMax.X, Brush.BoundsMax.X), FMath::Min(BoundsMax.Y, Brush.BoundsMax.Y), FMath::Min(BoundsMax.Z, Brush.BoundsMax.Z));
+	Combine<FSubtractOp>(Brush, OutChanged, From, To);
+}
+
+void FVoxelBitset::Intersect(const FVoxelBitset& Brush, FVoxelBitset& OutChanged)
+{
+	//cells can only be cleared inside own bounds, brush out of them is zero
+	Combine<FIntersectOp>(Brush, OutChanged, BoundsMin, BoundsMax);
+}
+
+/**
+ * Combine
+ * Apply operation to every word of rows from From to To and write bits
+ * changed by it to OutChanged, bounds of OutChanged are the rows combined.
+ * @param From Box space first cell
+ * @param To Box space last cell
+ */
+template <typename OpType>
+void FVoxelBitset::Combine(const FVoxelBitset& Brush, FVoxelBitset& OutChanged, const FIntVector& From, const FIntVector& To)
+{
+	check(Brush.Min == Min && Brush.Extent == Extent);
+	check(&OutChanged != this && &OutChanged != &Brush);
+	OutChanged.Init(Min, Extent);
+	const FIntVector First(FMath::Max(From.X, 0), FMath::Max(From.Y, 0), FMath::Max(From.Z, 0));
+	const FIntVector Last(FMath::Min(To.X, Extent.X - 1), FMath::Min(To.Y, Extent.Y - 1), FMath::Min(To.Z, Extent.Z - 1));
+	if (Last.X < First.X || Last.Y < First.Y || Last.Z < First.Z) return;
+	const int32 FirstWord = First.X >> 6, LastWord = Last.X >> 6;
+	for (int32 Z = First.Z; Z <= Last.Z; ++Z) {
+		for (int32 Y = First.Y; Y <= Last.Y; ++Y) {
+			const int32 Row = GetRow(Y, Z);
+			uint64* Target = Words.GetData() + Row;
+			const uint64* Source = Brush.Words.GetData() + Row;
+			uint64* Changed = OutChanged.Words.GetData() + Row;
+			int32 Word = FirstWord;
+			for (; Word + 1 <= LastWord; Word += 2) {
+				const VectorRegisterInt Old = VectorIntLoad(Target + Word);
+				const VectorRegisterInt Result = OpType::Apply(Old, VectorIntLoad(Source + Word));
+				VectorIntStore(VectorIntXor(Old, Result), Changed + Word);
+				VectorIntStore(Result, Target + Word);
+			}
+			for (; Word <= LastWord; ++Word) {
+				const uint64 Result = OpType::Apply(Target[Word], Source[Word]);
+				Changed[Word] = Target[Word] ^ Result;
+				Target[Word] = Result;
+			}
+		}
+	}
+	OutChanged.AddBounds(First, Last);
+}
+
+void FVoxelBitset::SetSpan(int32 X0, int32 X1, int32 Y, int32 Z)
+{
+	X0 = FMath::Max(X0, 0);
+	X1 = FMath::Min(X1, Extent.X - 1);
+	if (X1 < X0) return;
+	uint64* Row = Words.GetData() + GetRow(Y, Z);
+	const int32 FirstWord = X0 >> 6, LastWord = X1 >> 6;
+	const uint64 FirstMask = ~0ull << (X0 & 63);
+	const uint64 LastMask = ~0ull >> (63 - (X1 & 63));
+	if (FirstWord == LastWord) {
+		Row[FirstWord] |= FirstMask & LastMask;
+	} else {
+		Row[FirstWord] |= FirstMask;
+		for (int32 Word = FirstWord + 1; Word < LastWord; ++Word) {
+			Row[Word] = ~0ull;
+		}
+		Row[LastWord] |= LastMask;
+	}
+	AddBounds(FIntVector(X0, Y, Z), FIntVector(X1, Y, Z));
+}
+
+void FVoxelBitset::AddBounds(const FIntVector& InMin, const FIntVector& InMax)
+{
+	BoundsMin = FIntVector(FMath::Min(BoundsMin.X, InMin.X), FMath::Min(BoundsMin.Y, InMin.Y), FMath::Min(BoundsMin.Z, InMin.Z));
+	BoundsMax = FIntVector(FMath::Max(BoundsMax.X, InMax.X), FMath::Max(BoundsMax.Y, InMax.Y), FMath::Max(BoundsMax.Z, InMax.Z));
+}
@@ -2,17 +2,41 @@
 
 #include "VoxelComponent.h"
 #include <Components/InstancedStaticMeshComponent.h>
-#include <Containers/ArrayBuilder.h>
 #include <Engine/StaticMesh.h>
 #include "Voxel.h"
 
+static const FIntVector Directions[6] = {
+	FIntVector(+0, +0, +1),	// Up
+	FIntVector(+0, +0, -1),	// Down
+	FIntVector(+1, +0, +0),	// Forward
+	FIntVector(-1, +0, +0),	// Backward
+	FIntVector(+0, +1, +0),	// Right
+	FIntVector(+0, -1, +0),	// Left
+};
+
 UVoxelComponent::UVoxelComponent()
 	: CellBounds(FVector::ZeroVector, FVector(100.f, 100.f, 100.f), 100.f)
 	, bHideUnbeheld(true)
+	, bHideEnclosed(false)
 	, Mesh()
 	, Cell()
+	, RemovedCell()
 	, Voxel(nullptr)
+	, bDetachIslands(false)
+	, AnchorCell()
 	, InstancedStaticMeshComponents()
+	, Visibility()
+	, Grid()
+	, Occupancy()
+	, BrushCells()
+	, ChangedCells()
+	, CellInstance()
+	, InstanceCell()
+	, Connectivity()
+	, DetachedCells()
+	, DetachedIslands()
+	, EditedCells()
+	, ExteriorCells()
 {
 }
 
@@ -20,10 +44,20 @@ UVoxelComponent::UVoxelComponent()
 void UVoxelComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	static const FName NAME_HideUnbeheld = FName(TEXT("bHideUnbeheld"));
+	static const FName NAME_HideEnclosed = FName(TEXT("bHideEnclosed"));
 	static const FName NAME_Mesh = FName(TEXT("Mesh"));
 	static const FName NAME_Voxel = FName(TEXT("Voxel"));
+	static const FName NAME_Cell = FName(TEXT("Cell"));
+	static const FName NAME_RemovedCell = FName(TEXT("RemovedCell"));
+	static const FName NAME_DetachIslands = FName(TEXT("bDetachIslands"));
+	static const FName NAME_AnchorCell = FName(TEXT("AnchorCell"));
 	if (PropertyChangedEvent.Property) {
 		if (PropertyChangedEvent.Property->GetFName() == NAME_HideUnbeheld) {
+			InitVisibility();
+			ClearVoxel();
+			AddVoxel();
+		} else if (PropertyChangedEvent.Property->GetFName() == NAME_HideEnclosed) {
+			InitVisibility();
 			ClearVoxel();
 			AddVoxel();
 		} else if (PropertyChangedEvent.Property->GetFName() == NAME_Mesh) {
@@ -39,6 +73,17 @@ void UVoxelComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChan
 			SetVoxel(Voxel, true);
 		}
 	}
+	if (PropertyChangedEvent.MemberProperty && Voxel) {
+		const FName MemberName = PropertyChangedEvent.MemberProperty->GetFName();
+		if (MemberName == NAME_Cell || MemberName == NAME_RemovedCell) {
+			ResetOccupancy();
+			InitVisibility();
+			ClearVoxel();
+			AddVoxel();
+		} else if (MemberName == NAME_DetachIslands || MemberName == NAME_AnchorCell) {
+			InitConnectivity();
+		}
+	}
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 }
 #endif // WITH_EDITOR
@@ -51,6 +96,25 @@ void UVoxelComponent::SetVoxel(class UVoxel* InVoxel, bool bForce /*= false*/)
 	}
 }
 
+/**
+ * PostLoad
+ * Components saved before cells of voxel asset were shared hold a copy of
+ * every cell, overlay keeps only cells differing from voxel asset.
+ */
+void UVoxelComponent::PostLoad()
+{
+	Super::PostLoad();
+	if (Voxel && 0 < Cell.Num()) {
+		Voxel->ConditionalPostLoad();
+		for (auto It = Cell.CreateIterator(); It; ++It) {
+			if (GetGrid().Get(It.Key()) == It.Value()) {
+				It.RemoveCurrent();
+			}
+		}
+		Cell.Compact();
+	}
+}
+
 const UVoxel* UVoxelComponent::GetVoxel() const
 {
 	return Voxel;
@@ -61,29 +125,100 @@ void UVoxelComponent::InitVoxel()
 	CellBounds = FBoxSphereBounds(FVector::ZeroVector, FVector(100.f, 100.f, 100.f), 100.f);
 	Mesh.Empty();
 	Cell.Empty();
+	RemovedCell.Empty();
+	Grid.Reset();
 	InstancedStaticMeshComponents.Empty();
+	CellInstance.Empty();
+	InstanceCell.Empty();
+	ResetOccupancy();
 	if (Voxel) {
+		Grid = Voxel->GetSharedGrid();
 		CellBounds = Voxel->CellBounds;
 		Mesh = Voxel->Mesh;
-		Cell = Voxel->Voxel;
+		InitVisibility();
 		for (int32 i = 0; i < Mesh.Num(); ++i) {
 			UInstancedStaticMeshComponent* Proxy = NewObject<UInstancedStaticMeshComponent>(this, NAME_None, RF_Transactional);
 			Proxy->SetStaticMesh(Mesh[i]);
 			Proxy->AttachToComponent(GetOwner()->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform, NAME_None);
 			InstancedStaticMeshComponents.Add(Proxy);
 		}
+		InstanceCell.SetNum(Mesh.Num());
 		AddVoxel();
 	}
 }
 
+/**
+ * InitVisibility
+ * Exterior space is read only to hide unbeheld cells, so built only if both
+ * flags are set.
+ */
+void UVoxelComponent::InitVisibility()
+{
+	Visibility = FVoxelVisibility();
+	if (Voxel && bHideEnclosed && bHideUnbeheld) {
+		Visibility.Build(Voxel->Size, GetGrid(), &Cell, &RemovedCell);
+	}
+}
+
+/**
+ * InitOccupancy
+ * Built by first edit only, so components never edited keep no storage in
+ * proportion to voxel size. Cells out of voxel size are left to overlay and
+ * never changed by brushes.
+ */
+void UVoxelComponent::InitOccupancy()
+{
+	if (!Voxel || Occupancy.GetExtent() == Voxel->Size) return;
+	Occupancy.Init(FIntVector::ZeroValue, Voxel->Size);
+	GetGrid().ForEach([&](const FIntVector& InVector, uint8 Value) {
+		if (!RemovedCell.Contains(InVector)) Occupancy.Set(InVector);
+	});
+	for (const auto& Overlay : Cell) {
+		Occupancy.Set(Overlay.Key);
+	}
+	InitConnectivity();
+}
+
+void UVoxelComponent::ResetOccupancy()
+{
+	//release storage, solid cells fall back to cells until next edit
+	Occupancy = FVoxelBitset();
+	BrushCells = FVoxelBitset();
+	ChangedCells = FVoxelBitset();
+	Connectivity.Reset();
+}
+
+/**
+ * InitConnectivity
+ * Built with occupancy by first edit. Pieces apart from anchors before it
+ * are left in place.
+ */
+void UVoxelComponent::InitConnectivity()
+{
+	Connectivity.Reset();
+	if (!Voxel || !bDetachIslands || Occupancy.GetExtent() != Voxel->Size) return;
+	FVoxelBitset Anchor(Occupancy.GetMin(), Occupancy.GetExtent());
+	if (AnchorCell.Num() == 0) {
+		Anchor.SetBox(FIntVector::ZeroValue, FIntVector(Voxel->Size.X - 1, Voxel->Size.Y - 1, 0));
+	}
+	for (const FIntVector& InVector : AnchorCell) {
+		Anchor.Set(InVector);
+	}
+	Connectivity.Build(Occupancy, Anchor);
+}
+
 void UVoxelComponent::AddVoxel()
 {
-	FVector Offset = Voxel->bXYCenter ? FVector((float)Voxel->Size.X, (float)Voxel->Size.Y, 0.f) * CellBounds.BoxExtent : FVector::ZeroVector;
-	for (auto& voxel : Voxel->Voxel) {
-		if (bHideUnbeheld && IsUnbeheldVolume(voxel.Key)) continue;
-		FVector Translation = FVector(voxel.Key) * CellBounds.BoxExtent * 2 -CellBounds.Origin + CellBounds.BoxExtent - Offset;
-		FTransform Transform(FQuat::Identity, Translation, FVector(1.f));
-		InstancedStaticMeshComponents[voxel.Value]->AddInstance(Transform);
+	auto AddVisibleInstance = [&](const FIntVector& InVector, uint8 Value) {
+		if (CellInstance.Contains(InVector)) return;
+		if (bHideUnbeheld && IsUnbeheldVolume(InVector)) return;
+		AddInstance(InVector, Value);
+	};
+	GetGrid().ForEach([&](const FIntVector& InVector, uint8 Value) {
+		if (!Cell.Contains(InVector) && !RemovedCell.Contains(InVector)) AddVisibleInstance(InVector, Value);
+	});
+	for (const auto& Overlay : Cell) {
+		AddVisibleInstance(Overlay.Key, Overlay.Value);
 	}
 }
 
@@ -92,38 +227,341 @@ void UVoxelComponent::ClearVoxel()
 	for (int32 i = 0; i < Mesh.Num(); ++i) {
 		InstancedStaticMeshComponents[i]->ClearInstances();
 	}
+	CellInstance.Reset();
+	InstanceCell.SetNum(Mesh.Num());
+	for (TArray<FIntVector>& Cells : InstanceCell) {
+		Cells.Reset();
+	}
 }
 
-bool UVoxelComponent::IsUnbeheldVolume(const FIntVector& InVector) const
+int32 UVoxelComponent::GetCell(const FIntVector& InVector) const
+{
+	if (const uint8* Value = Cell.Find(InVector)) {
+		return *Value;
+	}
+	return RemovedCell.Contains(InVector) ? INDEX_NONE : GetGrid().Get(InVector);
+}
+
+/**
+ * SetCell
+ * Shared grid is never written, changed cells are kept in component overlay.
+ * @param InVector Cell coordinate
+ * @param Value Mesh index of cell
+ */
+bool UVoxelComponent::SetCell(const FIntVector& InVector, uint8 Value)
 {
-	static const TArray<FIntVector> Direction = TArrayBuilder<FIntVector>()
-		.Add(FIntVector(+0, +0, +1))	// Up
-		.Add(FIntVector(+0, +0, -1))	// Down
-		.Add(FIntVector(+1, +0, +0))	// Forward
-		.Add(FIntVector(-1, +0, +0))	// Backward
-		.Add(FIntVector(+0, +1, +0))	// Right
-		.Add(FIntVector(+0, -1, +0));	// Left
-	int count = 0;
-	for (int i = 0; i < Direction.Num(); ++i) {
-		if (Voxel->Voxel.Contains(InVector + Direction[i])) {
-			++count;
+	if (!Voxel || !Mesh.IsValidIndex(Value)) return false;
+	InitOccupancy();
+	const bool bAdded = !IsSolid(InVector);
+	WriteCell(InVector, Value);
+	if (bAdded) {
+		Connectivity.Add(MakeArrayView(&InVector, 1));
+	}
+	UpdateInstances(MakeArrayView(&InVector, 1));
+	return true;
+}
+
+/**
+ * RemoveCell
+ * @param InVector Cell coordinate
+ */
+bool UVoxelComponent::RemoveCell(const FIntVector& InVector)
+{
+	if (!Voxel || GetCell(InVector) == INDEX_NONE) return false;
+	InitOccupancy();
+	EraseCell(InVector);
+	EditedCells.Reset();
+	EditedCells.Add(InVector);
+	DetachIslands(EditedCells);
+	UpdateInstances(EditedCells);
+	BroadcastIslands();
+	return true;
+}
+
+const FVoxelBitset& UVoxelComponent::GetOccupancy() const
+{
+	return Occupancy;
+}
+
+/**
+ * Combine
+ * Occupancy is combined a word at a time and only changed cells reach the
+ * overlay, so brushes cost their bounds and changed cells, not the model.
+ * @param Op Boolean operation
+ * @param Brush Brush cells in box of occupancy
+ * @param GetValue Value of every cell added by union
+ * @param OutChanged Cells added or removed, with cells of detached pieces, storage is kept
+ */
+int32 UVoxelComponent::Combine(EVoxelBooleanOp Op, const FVoxelBitset& Brush, TFunctionRef<uint8(const FIntVector&)> GetValue, TArray<FIntVector>& OutChanged)
+{
+	OutChanged.Reset();
+	if (!Voxel) return 0;
+	InitOccupancy();
+	switch (Op) {
+	case EVoxelBooleanOp::Union:
+		Occupancy.Union(Brush, ChangedCells);
+		break;
+	case EVoxelBooleanOp::Subtract:
+		Occupancy.Subtract(Brush, ChangedCells);
+		break;
+	case EVoxelBooleanOp::Intersect:
+		Occupancy.Intersect(Brush, ChangedCells);
+		break;
+	}
+	ChangedCells.ForEach([&](const FIntVector& InVector) {
+		OutChanged.Add(InVector);
+		if (Op == EVoxelBooleanOp::Union) {
+			WriteCell(InVector, GetValue(InVector));
+		} else {
+			EraseCell(InVector);
 		}
+	});
+	if (Op == EVoxelBooleanOp::Union) {
+		Connectivity.Add(OutChanged);
+	} else {
+		DetachIslands(OutChanged);
+	}
+	UpdateInstances(OutChanged);
+	BroadcastIslands();
+	return OutChanged.Num();
+}
+
+int32 UVoxelComponent::CombineSphere(EVoxelBooleanOp Op, const FVector& Center, float Radius, uint8 Value, TArray<FIntVector>& OutChanged)
+{
+	if (Op == EVoxelBooleanOp::Union && !Mesh.IsValidIndex(Value)) {
+		OutChanged.Reset();
+		return 0;
 	}
-	return Direction.Num() == count;
+	InitOccupancy();
+	BrushCells.Init(Occupancy.GetMin(), Occupancy.GetExtent());
+	BrushCells.SetSphere(Center, Radius);
+	return Combine(Op, BrushCells, [Value](const FIntVector&) { return Value; }, OutChanged);
+}
+
+int32 UVoxelComponent::CombineBox(EVoxelBooleanOp Op, const FIntVector& BoxMin, const FIntVector& BoxMax, uint8 Value, TArray<FIntVector>& OutChanged)
+{
+	if (Op == EVoxelBooleanOp::Union && !Mesh.IsValidIndex(Value)) {
+		OutChanged.Reset();
+		return 0;
+	}
+	InitOccupancy();
+	BrushCells.Init(Occupancy.GetMin(), Occupancy.GetExtent());
+	BrushCells.SetBox(BoxMin, BoxMax);
+	return Combine(Op, BrushCells, [Value](const FIntVector&) { return Value; }, OutChanged);
+}
+
+/**
+ * CombineVoxel
+ * @param InVoxel Voxel asset of brush, cells of values without mesh here are skipped by union
+ * @param Offset Cell of this component at cell 0 of brush
+ */
+int32 UVoxelComponent::CombineVoxel(EVoxelBooleanOp Op, const UVoxel* InVoxel, const FIntVector& Offset, TArray<FIntVector>& OutChanged)
+{
+	if (!InVoxel) {
+		OutChanged.Reset();
+		return 0;
+	}
+	const FVoxelGrid& BrushGrid = InVoxel->GetGrid();
+	InitOccupancy();
+	BrushCells.Init(Occupancy.GetMin(), Occupancy.GetExtent());
+	BrushGrid.ForEach([&](const FIntVector& InVector, uint8 Value) {
+		if (Op != EVoxelBooleanOp::Union || Mesh.IsValidIndex(Value)) BrushCells.Set(InVector + Offset);
+	});
+	return Combine(Op, BrushCells, [&](const FIntVector& InVector) { return (uint8)BrushGrid.Get(InVector - Offset); }, OutChanged);
+}
+
+void UVoxelComponent::SetDetachIslands(bool bInDetachIslands)
+{
+	if (bDetachIslands != bInDetachIslands) {
+		bDetachIslands = bInDetachIslands;
+		InitConnectivity();
+	}
+}
+
+void UVoxelComponent::SetAnchorCell(const TSet<FIntVector>& InAnchorCell)
+{
+	AnchorCell = InAnchorCell;
+	InitConnectivity();
+}
+
+/**
+ * DetachIslands
+ * Only pieces of removed cells are searched, see FVoxelConnectivity. Cells
+ * of detached pieces are removed now and broadcast once instances match.
+ * @param InOutChanged Removed cells, cells of detached pieces are appended
+ */
+void UVoxelComponent::DetachIslands(TArray<FIntVector>& InOutChanged)
+{
+	if (!Connectivity.IsBuilt()) return;
+	Connectivity.Remove(InOutChanged, DetachedCells);
+	for (const TArray<FIntVector>& Cells : DetachedCells) {
+		FVoxelIsland& Island = DetachedIslands[DetachedIslands.AddDefaulted()];
+		Island.Cell.Reserve(Cells.Num());
+		for (const FIntVector& InVector : Cells) {
+			Island.Cell.Add(InVector, (uint8)GetCell(InVector));
+			EraseCell(InVector);
+		}
+		InOutChanged.Append(Cells);
+	}
+}
+
+void UVoxelComponent::BroadcastIslands()
+{
+	if (DetachedIslands.Num() == 0) return;
+	//handlers may edit cells and detach again
+	TArray<FVoxelIsland> Islands = MoveTemp(DetachedIslands);
+	DetachedIslands.Reset();
+	for (const FVoxelIsland& Island : Islands) {
+		OnIslandDetached.Broadcast(this, Island);
+	}
+}
+
+void UVoxelComponent::WriteCell(const FIntVector& InVector, uint8 Value)
+{
+	RemovedCell.Remove(InVector);
+	if (GetGrid().Get(InVector) == Value) {
+		Cell.Remove(InVector);
+	} else {
+		Cell.Add(InVector, Value);
+	}
+	Occupancy.Set(InVector);
+}
+
+void UVoxelComponent::EraseCell(const FIntVector& InVector)
+{
+	Cell.Remove(InVector);
+	if (GetGrid().Contains(InVector)) {
+		RemovedCell.Add(InVector);
+	}
+	Occupancy.Set(InVector, false);
+}
+
+/**
+ * UpdateInstances
+ * Only cells next to changed cells can be hidden or revealed. If enclosed
+ * cells are hidden, a cavity may open or close far from them, and cells next
+ * to space entering or leaving exterior are updated too.
+ * @param InVectors Changed cells
+ */
+void UVoxelComponent::UpdateInstances(TArrayView<const FIntVector> InVectors)
+{
+	ExteriorCells.Reset();
+	if (Visibility.IsBuilt()) {
+		Visibility.Update(InVectors, [this](const FIntVector& InVector) { return IsSolid(InVector); }, ExteriorCells);
+	}
+	//instances of loaded components are not mapped to cells until rebuilt once
+	if (InstanceCell.Num() != Mesh.Num()) {
+		ClearVoxel();
+		AddVoxel();
+		return;
+	}
+	for (const FIntVector& InVector : InVectors) {
+		UpdateInstance(InVector);
+		if (bHideUnbeheld) {
+			for (const FIntVector& Direction : Directions) {
+				UpdateInstance(InVector + Direction);
+			}
+		}
+	}
+	for (const FIntVector& InVector : ExteriorCells) {
+		for (const FIntVector& Direction : Directions) {
+			UpdateInstance(InVector + Direction);
+		}
+	}
+}
+
+void UVoxelComponent::UpdateInstance(const FIntVector& InVector)
+{
+	const int32 Value = GetCell(InVector);
+	const bool bDrawn = Value != INDEX_NONE && !(bHideUnbeheld && IsUnbeheldVolume(InVector));
+	const FVoxelInstance* Instance = CellInstance.Find(InVector);
+	if (Instance && (!bDrawn || Instance->Mesh != Value)) {
+		RemoveInstance(InVector);
+		Instance = nullptr;
+	}
+	if (bDrawn && !Instance) {
+		AddInstance(InVector, Value);
+	}
+}
+
+void UVoxelComponent::AddInstance(const FIntVector& InVector, int32 Value)
+{
+	const int32 Index = InstancedStaticMeshComponents[Value]->AddInstance(GetCellTransform(InVector));
+	check(Index == InstanceCell[Value].Num());
+	CellInstance.Add(InVector, FVoxelInstance{ Value, Index });
+	InstanceCell[Value].Add(InVector);
+}
+
+/**
+ * RemoveInstance
+ * Removing other than last instance shifts every later one, so last one
+ * moves into the hole and is removed instead.
+ * @param InVector Cell of instance
+ */
+void UVoxelComponent::RemoveInstance(const FIntVector& InVector)
+{
+	FVoxelInstance Instance;
+	if (!CellInstance.RemoveAndCopyValue(InVector, Instance)) return;
+	UInstancedStaticMeshComponent* Component = InstancedStaticMeshComponents[Instance.Mesh];
+	TArray<FIntVector>& Cells = InstanceCell[Instance.Mesh];
+	const int32 Last = Cells.Num() - 1;
+	if (Instance.Index != Last) {
+		FTransform Transform;
+		Component->GetInstanceTransform(Last, Transform);
+		Component->UpdateInstanceTransform(Instance.Index, Transform);
+		Cells[Instance.Index] = Cells[Last];
+		CellInstance[Cells[Instance.Index]].Index = Instance.Index;
+	}
+	Component->RemoveInstance(Last);
+	Cells.Pop(false);
+}
+
+const FVoxelGrid& UVoxelComponent::GetGrid() const
+{
+	static const FVoxelGrid EmptyGrid;
+	return Grid.IsValid() ? *Grid : Voxel ? Voxel->GetGrid() : EmptyGrid;
+}
+
+bool UVoxelComponent::IsUnbeheldVolume(const FIntVector& InVector) const
+{
+	if (bHideEnclosed && Visibility.IsBuilt()) {
+		return !Visibility.IsVisible(InVector);
+	}
+	for (const FIntVector& Direction : Directions) {
+		if (!IsSolid(InVector + Direction)) return false;
+	}
+	return true;
+}
+
+bool UVoxelComponent::IsSolid(const FIntVector& InVector) const
+{
+	return Occupancy.IsInside(InVector) ? Occupancy.Test(InVector) : GetCell(InVector) != INDEX_NONE;
 }
 
 bool UVoxelComponent::GetVoxelTransform(const FIntVector& InVector, FTransform& OutVoxelTransform, bool bWorldSpace /*= false*/) const
 {
-	if (!Cell.Contains(InVector)) return false;
-	FVector Offset = Voxel->bXYCenter ? FVector((float)Voxel->Size.X, (float)Voxel->Size.Y, 0.f) * CellBounds.BoxExtent : FVector::ZeroVector;
-	FVector Translation = FVector(InVector) * CellBounds.BoxExtent * 2 - CellBounds.Origin + CellBounds.BoxExtent - Offset;
-	OutVoxelTransform = FTransform(FQuat::Identity, Translation, FVector(1.f));
+	if (GetCell(InVector) == INDEX_NONE) return false;
+	OutVoxelTransform = GetCellTransform(InVector);
 	if (bWorldSpace) {
 		OutVoxelTransform = OutVoxelTransform * GetComponentToWorld();
 	}
 	return true;
 }
 
+FVector UVoxelComponent::GetCellCoordinate(const FVector& Location, bool bWorldSpace /*= false*/) const
+{
+	if (!Voxel) return FVector::ZeroVector;
+	const FVector LocalLocation = bWorldSpace ? GetComponentToWorld().InverseTransformPosition(Location) : Location;
+	return (LocalLocation - GetCellTransform(FIntVector::ZeroValue).GetTranslation()) / (CellBounds.BoxExtent * 2.f);
+}
+
+FTransform UVoxelComponent::GetCellTransform(const FIntVector& InVector) const
+{
+	FVector Offset = Voxel->bXYCenter ? FVector((float)Voxel->Size.X, (float)Voxel->Size.Y, 0.f) * CellBounds.BoxExtent : FVector::ZeroVector;
+	FVector Translation = FVector(InVector) * CellBounds.BoxExtent * 2 - CellBounds.Origin + CellBounds.BoxExtent - Offset;
+	return FTransform(FQuat::Identity, Translation, FVector(1.f));
+}
+
 FBoxSphereBounds UVoxelComponent::CalcBounds(const FTransform& LocalToWorld) const
 {
 	FBoxSphereBounds Bounds = FBoxSphereBounds(ForceInit);
@@ -133,6 +571,19 @@ FBoxSphereBounds UVoxelComponent::CalcBounds(const FTransform& LocalToWorld) con
 	return Bounds;
 }
 
+void UVoxelComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+	//shared grid is counted by voxel asset
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Cell.GetAllocatedSize() + RemovedCell.GetAllocatedSize());
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Occupancy.GetAllocatedSize() + BrushCells.GetAllocatedSize() + ChangedCells.GetAllocatedSize());
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(CellInstance.GetAllocatedSize() + InstanceCell.GetAllocatedSize());
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Connectivity.GetAllocatedSize());
+	for (const TArray<FIntVector>& Cells : InstanceCell) {
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Cells.GetAllocatedSize());
+	}
+}
+
 const TArray<UInstancedStaticMeshComponent*>& UVoxelComponent::GetInstancedStaticMeshComponent() const
 {
 	return InstancedStaticMeshComponents;
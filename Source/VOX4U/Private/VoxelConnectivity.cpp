@@ -0,0 +1,303 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxelConnectivity.h"
+
+FVoxelConnectivity::FVoxelConnectivity()
+	: Min(ForceInitToZero)
+	, Extent(ForceInitToZero)
+	, StrideY(0)
+	, StrideZ(0)
+	, Offsets()
+	, Labels()
+	, Pieces()
+	, FreeLabels()
+	, Anchor()
+	, Seeds()
+	, Touched()
+	, Stack()
+	, Fronts()
+{
+}
+
+void FVoxelConnectivity::Build(const FVoxelBitset& Occupancy, const FVoxelBitset& InAnchor)
+{
+	Reset();
+	Min = Occupancy.GetMin();
+	Extent = Occupancy.GetExtent();
+	if (Extent.X <= 0 || Extent.Y <= 0 || Extent.Z <= 0) return;
+	StrideY = Extent.X + 2;
+	StrideZ = StrideY * (Extent.Y + 2);
+	const int32 NewOffsets[6] = { +StrideZ, -StrideZ, +1, -1, +StrideY, -StrideY };
+	FMemory::Memcpy(Offsets, NewOffsets, sizeof(Offsets));
+	Labels.Init(INDEX_NONE, StrideZ * (Extent.Z + 2));
+	Anchor = InAnchor;
+	//mark solid cells, then flood each piece from its first cell
+	const int32 Unlabelled = MAX_int32;
+	Occupancy.ForEach([&](const FIntVector& Cell) {
+		Labels[GetIndex(Cell)] = Unlabelled;
+	});
+	Occupancy.ForEach([&](const FIntVector& Cell) {
+		const int32 Index = GetIndex(Cell);
+		if (Labels[Index] == Unlabelled) {
+			const int32 Label = NewLabel();
+			Pieces[Label].Num = Flood(Index, Label);
+		}
+	});
+	Anchor.ForEach([&](const FIntVector& Cell) {
+		const int32 Index = GetIndex(Cell);
+		if (Index != INDEX_NONE && 0 <= Labels[Index]) ++Pieces[Labels[Index]].Anchors;
+	});
+}
+
+void FVoxelConnectivity::Reset()
+{
+	Labels.Reset();
+	Pieces.Reset();
+	FreeLabels.Reset();
+}
+
+/**
+ * Add
+ * Cost is relabelling every piece merged into a larger one.
+ * @param Cells Cells set in occupancy
+ */
+void FVoxelConnectivity::Add(TArrayView<const FIntVector> Cells)
+{
+	if (!IsBuilt()) return;
+	for (const FIntVector& Cell : Cells) {
+		const int32 Index = GetIndex(Cell);
+		if (Index == INDEX_NONE || 0 <= Labels[Index]) continue;
+		int32 Label = INDEX_NONE;
+		for (int32 Offset : Offsets) {
+			const int32 Neighbour = Labels[Index + Offset];
+			if (0 <= Neighbour && (Label == INDEX_NONE || Pieces[Label].Num < Pieces[Neighbour].Num)) {
+				Label = Neighbour;
+			}
+		}
+		if (Label == INDEX_NONE) {
+			Label = NewLabel();
+		}
+		Labels[Index] = Label;
+		++Pieces[Label].Num;
+		Pieces[Label].Anchors += IsAnchor(Index) ? 1 : 0;
+		for (int32 Offset : Offsets) {
+			const int32 Neighbour = Labels[Index + Offset];
+			if (0 <= Neighbour && Neighbour != Label) {
+				Pieces[Label].Num += Pieces[Neighbour].Num;
+				Pieces[Label].Anchors += Pieces[Neighbour].Anchors;
+				Flood(Index + Offset, Label);
+				FreeLabel(Neighbour);
+			}
+		}
+	}
+}
+
+/**
+ * Remove
+ * Every piece split off is a piece of a neighbour of removed cells, so
+ * searches from neighbours find them without walking the piece kept.
+ * @param Cells Cells cleared in occupancy
+ * @param OutDetached Cells of every piece detached
+ */
+void FVoxelConnectivity::Remove(TArrayView<const FIntVector> Cells, TArray<TArray<FIntVector>>& OutDetached)
+{
+	OutDetached.Reset();
+	if (!IsBuilt()) return;
+	Seeds.Reset();
+	Touched.Reset();
+	for (const FIntVector& Cell : Cells) {
+		const int32 Index = GetIndex(Cell);
+		if (Index == INDEX_NONE || Labels[Index] < 0) continue;
+		FPiece& Piece = Pieces[Labels[Index]];
+		if (!Piece.bTouched) {
+			Piece.bTouched = true;
+			Piece.bWasAnchored = 0 < Piece.Anchors;
+			Touched.Add(Labels[Index]);
+		}
+		--Piece.Num;
+		Piece.Anchors -= IsAnchor(Index) ? 1 : 0;
+		Labels[Index] = INDEX_NONE;
+		Seeds.Add(Index);
+	}
+	//neighbours left once every cell is unlabelled, by piece
+	const int32 NumRemoved = Seeds.Num();
+	for (int32 i = 0; i < NumRemoved; ++i) {
+		for (int32 Offset : Offsets) {
+			if (0 <= Labels[Seeds[i] + Offset]) Seeds.Add(Seeds[i] + Offset);
+		}
+	}
+	Seeds.RemoveAt(0, NumRemoved, false);
+	Seeds.Sort([this](int32 A, int32 B) { return Labels[A] < Labels[B]; });
+	for (int32 First = 0, Last = 0; First < Seeds.Num(); First = Last) {
+		const int32 Label = Labels[Seeds[First]];
+		while (Last < Seeds.Num() && Labels[Seeds[Last]] == Label) ++Last;
+		Split(Label, Seeds.GetData() + First, Last - First, OutDetached);
+	}
+	for (int32 Label : Touched) {
+		Pieces[Label].bTouched = false;
+		if (Pieces[Label].Num == 0) FreeLabel(Label);
+	}
+}
+
+/**
+ * Split
+ * Searches take one cell each in turn and join when they meet. Search left
+ * unfinished last keeps label, every finished one is a piece split off and
+ * no larger than cells searched by it.
+ * @param Label Piece of seeds
+ * @param InSeeds Cells of piece next to removed cells
+ */
+void FVoxelConnectivity::Split(int32 Label, const int32* InSeeds, int32 NumSeeds, TArray<TArray<FIntVector>>& OutDetached)
+{
+	const bool bWasAnchored = Pieces[Label].bWasAnchored;
+	int32 NumFronts = 0;
+	for (int32 i = 0; i < NumSeeds; ++i) {
+		if (Labels[InSeeds[i]] != Label) continue;
+		if (Fronts.Num() == NumFronts) Fronts.AddDefaulted();
+		FFront& Front = Fronts[NumFronts];
+		Front.Parent = NumFronts;
+		Front.Active = 1;
+		Front.Label = INDEX_NONE;
+		Front.Detached = INDEX_NONE;
+		Front.Anchors = 0;
+		Front.Head = 0;
+		Front.Cells.Reset();
+		Claim(NumFronts++, InSeeds[i]);
+	}
+	int32 ActiveGroups = NumFronts;
+	while (1 < ActiveGroups) {
+		for (int32 i = 0; i < NumFronts && 1 < ActiveGroups; ++i) {
+			if (Fronts[i].Head == Fronts[i].Cells.Num()) continue;
+			const int32 Index = Fronts[i].Cells[Fronts[i].Head++];
+			for (int32 Offset : Offsets) {
+				const int32 Neighbour = Labels[Index + Offset];
+				if (Neighbour == Label) {
+					Claim(i, Index + Offset);
+				} else if (Neighbour < INDEX_NONE) {
+					const int32 Root = FindRoot(i), Other = FindRoot(GetFrontLabel(Neighbour));
+					if (Root != Other) {
+						Fronts[Other].Parent = Root;
+						Fronts[Root].Active += Fronts[Other].Active;
+						--ActiveGroups;
+					}
+				}
+			}
+			if (Fronts[i].Head == Fronts[i].Cells.Num() && --Fronts[FindRoot(i)].Active == 0) {
+				--ActiveGroups;
+			}
+		}
+	}
+
+	//every root but the unfinished one is a piece split off
+	int32 Kept = INDEX_NONE;
+	for (int32 i = 0; i < NumFronts; ++i) {
+		if (FindRoot(i) == i && 0 < Fronts[i].Active) Kept = i;
+	}
+	for (int32 i = 0; i < NumFronts; ++i) {
+		FFront& Root = Fronts[FindRoot(i)];
+		const FFront& Front = Fronts[i];
+		if (&Root == &Fronts[Kept]) {
+			for (int32 Index : Front.Cells) {
+				Labels[Index] = Label;
+			}
+			continue;
+		}
+		if (Root.Label == INDEX_NONE) {
+			Root.Label = NewLabel();
+		}
+		for (int32 Index : Front.Cells) {
+			Labels[Index] = Root.Label;
+		}
+		Pieces[Root.Label].Num += Front.Cells.Num();
+		Pieces[Root.Label].Anchors += Front.Anchors;
+		Pieces[Label].Num -= Front.Cells.Num();
+		Pieces[Label].Anchors -= Front.Anchors;
+	}
+	if (!bWasAnchored) return;
+
+	//cells of fronts are cells of pieces split off, no flood needed
+	for (int32 i = 0; i < NumFronts; ++i) {
+		FFront& Root = Fronts[FindRoot(i)];
+		if (Root.Label == INDEX_NONE || 0 < Pieces[Root.Label].Anchors) continue;
+		if (Root.Detached == INDEX_NONE) {
+			Root.Detached = OutDetached.AddDefaulted();
+		}
+		TArray<FIntVector>& Detached = OutDetached[Root.Detached];
+		for (int32 Index : Fronts[i].Cells) {
+			Labels[Index] = INDEX_NONE;
+			Detached.Add(GetCell(Index));
+		}
+	}
+	for (int32 i = 0; i < NumFronts; ++i) {
+		if (FindRoot(i) == i && Fronts[i].Detached != INDEX_NONE) {
+			Pieces[Fronts[i].Label].Num = 0;
+			FreeLabel(Fronts[i].Label);
+		}
+	}
+	if (Pieces[Label].Anchors == 0 && 0 < Pieces[Label].Num) {
+		TArray<FIntVector>& Detached = OutDetached[OutDetached.AddDefaulted()];
+		Flood(Fronts[Kept].Cells[0], INDEX_NONE, &Detached);
+		Pieces[Label].Num = 0;
+	}
+}
+
+void FVoxelConnectivity::Claim(int32 Front, int32 Index)
+{
+	FFront& Target = Fronts[Front];
+	Labels[Index] = GetFrontLabel(Front);
+	Target.Cells.Add(Index);
+	Target.Anchors += IsAnchor(Index) ? 1 : 0;
+}
+
+int32 FVoxelConnectivity::FindRoot(int32 Front)
+{
+	while (Fronts[Front].Parent != Front) {
+		Fronts[Front].Parent = Fronts[Fronts[Front].Parent].Parent;
+		Front = Fronts[Front].Parent;
+	}
+	return Front;
+}
+
+int32 FVoxelConnectivity::Flood(int32 Start, int32 Label, TArray<FIntVector>* OutCells /*= nullptr*/)
+{
+	const int32 From = Labels[Start];
+	check(From != Label);
+	int32 Num = 0;
+	Stack.Reset();
+	Stack.Add(Start);
+	Labels[Start] = Label;
+	while (0 < Stack.Num()) {
+		const int32 Index = Stack.Pop(false);
+		++Num;
+		if (OutCells) OutCells->Add(GetCell(Index));
+		for (int32 Offset : Offsets) {
+			if (Labels[Index + Offset] == From) {
+				Labels[Index + Offset] = Label;
+				Stack.Add(Index + Offset);
+			}
+		}
+	}
+	return Num;
+}
+
+int32 FVoxelConnectivity::NewLabel()
+{
+	const int32 Label = 0 < FreeLabels.Num() ? FreeLabels.Pop(false) : Pieces.AddUninitialized();
+	Pieces[Label] = FPiece{ 0, 0, false, false };
+	return Label;
+}
+
+void FVoxelConnectivity::FreeLabel(int32 Label)
+{
+	FreeLabels.Add(Label);
+}
+
+SIZE_T FVoxelConnectivity::GetAllocatedSize() const
+{
+	SIZE_T Size = Labels.GetAllocatedSize() + Pieces.GetAllocatedSize() + FreeLabels.GetAllocatedSize() + Anchor.GetAllocatedSize();
+	Size += Seeds.GetAllocatedSize() + Touched.GetAllocatedSize() + Stack.GetAllocatedSize() + Fronts.GetAllocatedSize();
+	for (const FFront& Front : Fronts) {
+		Size += Front.Cells.GetAllocatedSize();
+	}
+	return Size;
+}
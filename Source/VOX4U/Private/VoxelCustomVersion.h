@@ -0,0 +1,31 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Misc/Guid.h>
+
+/**
+ * Custom serialization version of VOX4U runtime assets
+ */
+struct FVoxelCustomVersion
+{
+	enum Type
+	{
+		/** Cells saved by tagged property serialization */
+		BeforeCustomVersionWasAdded = 0,
+		/** Cells saved as compressed run length encoded grid */
+		CompactCells,
+		/** Cooked cells saved as flat grid */
+		FlatGrid,
+
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	static const FGuid GUID;
+
+private:
+
+	FVoxelCustomVersion() {}
+};
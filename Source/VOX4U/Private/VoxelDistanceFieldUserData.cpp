@@ -0,0 +1,96 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxelDistanceFieldUserData.h"
+#include <DistanceFieldAtlas.h>
+#include <Engine/StaticMesh.h>
+#include <StaticMeshResources.h>
+
+UVoxelDistanceFieldUserData::UVoxelDistanceFieldUserData()
+	: Size(ForceInitToZero)
+	, LocalBoundingBox(ForceInit)
+	, DistanceMinMax(ForceInitToZero)
+	, bMeshWasClosed(true)
+	, bBuiltAsIfTwoSided(false)
+	, bMeshWasPlane(false)
+	, CompressedDistanceFieldVolume()
+{
+}
+
+void UVoxelDistanceFieldUserData::PostLoad()
+{
+	Super::PostLoad();
+	UStaticMesh* StaticMesh = Cast<UStaticMesh>(GetOuter());
+	if (StaticMesh) {
+		//render data is built or fetched in post load of mesh
+		StaticMesh->ConditionalPostLoad();
+		ApplyTo(StaticMesh);
+	}
+}
+
+#if WITH_EDITOR
+void UVoxelDistanceFieldUserData::PostEditChangeOwner()
+{
+	Super::PostEditChangeOwner();
+	UStaticMesh* StaticMesh = Cast<UStaticMesh>(GetOuter());
+	if (StaticMesh) {
+		//mesh was rebuilt with empty field
+		ApplyTo(StaticMesh);
+	}
+}
+#endif
+
+void UVoxelDistanceFieldUserData::SetDistanceField(const FDistanceFieldVolumeData& DistanceField)
+{
+	Size = DistanceField.Size;
+	LocalBoundingBox = DistanceField.LocalBoundingBox;
+	DistanceMinMax = DistanceField.DistanceMinMax;
+	bMeshWasClosed = DistanceField.bMeshWasClosed;
+	bBuiltAsIfTwoSided = DistanceField.bBuiltAsIfTwoSided;
+	bMeshWasPlane = DistanceField.bMeshWasPlane;
+	CompressedDistanceFieldVolume = DistanceField.CompressedDistanceFieldVolume;
+}
+
+/**
+ * ApplyTo
+ * Skipped if the mesh was set to a resolution scale other than 0 after
+ * import, which asks the engine for a field traced from triangles.
+ * @param StaticMesh Outer mesh of user data
+ */
+void UVoxelDistanceFieldUserData::ApplyTo(UStaticMesh* StaticMesh) const
+{
+	check(IsInGameThread());
+	if (CompressedDistanceFieldVolume.Num() == 0 || !StaticMesh->RenderData || StaticMesh->RenderData->LODResources.Num() == 0) {
+		return;
+	}
+#if WITH_EDITORONLY_DATA
+	if (0 < StaticMesh->SourceModels.Num() && StaticMesh->SourceModels[0].BuildSettings.DistanceFieldResolutionScale != 0.f) {
+		return;
+	}
+#endif
+#if WITH_EDITOR
+	//empty field queued by build would overwrite ours when done
+	if (GDistanceFieldAsyncQueue) {
+		GDistanceFieldAsyncQueue->BlockUntilBuildComplete(StaticMesh, false);
+	}
+#endif
+	FStaticMeshComponentRecreateRenderStateContext RecreateRenderStateContext(StaticMesh, false);
+	const bool bInitialized = StaticMesh->RenderData->IsInitialized();
+	if (bInitialized) {
+		StaticMesh->ReleaseResources();
+		StaticMesh->ReleaseResourcesFence.Wait();
+	}
+	FDistanceFieldVolumeData* DistanceField = new FDistanceFieldVolumeData();
+	DistanceField->Size = Size;
+	DistanceField->LocalBoundingBox = LocalBoundingBox;
+	DistanceField->DistanceMinMax = DistanceMinMax;
+	DistanceField->bMeshWasClosed = bMeshWasClosed;
+	DistanceField->bBuiltAsIfTwoSided = bBuiltAsIfTwoSided;
+	DistanceField->bMeshWasPlane = bMeshWasPlane;
+	DistanceField->CompressedDistanceFieldVolume = CompressedDistanceFieldVolume;
+	FStaticMeshLODResources& LODResources = StaticMesh->RenderData->LODResources[0];
+	delete LODResources.DistanceFieldData;
+	LODResources.DistanceFieldData = DistanceField;
+	if (bInitialized) {
+		StaticMesh->InitResources();
+	}
+}
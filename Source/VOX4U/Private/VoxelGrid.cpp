@@ -0,0 +1,59 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxelGrid.h"
+
+FVoxelGrid::FVoxelGrid()
+	: Min(ForceInitToZero)
+	, Extent(ForceInitToZero)
+	, NumCells(0)
+	, Cells()
+{
+}
+
+FVoxelGrid::FVoxelGrid(const TMap<FIntVector, uint8>& InCells)
+	: FVoxelGrid()
+{
+	if (InCells.Num() == 0) return;
+	FIntVector Max(MIN_int32);
+	Min = FIntVector(MAX_int32);
+	for (const auto& Cell : InCells) {
+		Min = FIntVector(FMath::Min(Min.X, Cell.Key.X), FMath::Min(Min.Y, Cell.Key.Y), FMath::Min(Min.Z, Cell.Key.Z));
+		Max = FIntVector(FMath::Max(Max.X, Cell.Key.X), FMath::Max(Max.Y, Cell.Key.Y), FMath::Max(Max.Z, Cell.Key.Z));
+	}
+	Extent = Max - Min + FIntVector(1);
+	Cells.SetNumZeroed(Extent.X * Extent.Y * Extent.Z);
+	for (const auto& Cell : InCells) {
+		check(Cell.Value < MAX_uint8);
+		Cells[GetIndex(Cell.Key)] = Cell.Value + 1;
+	}
+	NumCells = InCells.Num();
+}
+
+FVoxelGrid::FVoxelGrid(const FIntVector& InMin, const FIntVector& InExtent, TArray<uint8>&& InCells)
+	: FVoxelGrid()
+{
+	if (InExtent.X <= 0 || InExtent.Y <= 0 || InExtent.Z <= 0 || InCells.Num() != InExtent.X * InExtent.Y * InExtent.Z) return;
+	Min = InMin;
+	Extent = InExtent;
+	Cells = MoveTemp(InCells);
+	for (uint8 Value : Cells) {
+		NumCells += Value ? 1 : 0;
+	}
+}
+
+/**
+ * FIntVector	: min of cell bounds
+ * FIntVector	: extent of cell bounds
+ * int32		: num of cells
+ * uint8 x N	: value + 1 or 0 in x, y, z order
+ */
+FArchive& operator<<(FArchive& Ar, FVoxelGrid& Grid)
+{
+	Ar << Grid.Min << Grid.Extent << Grid.NumCells;
+	Grid.Cells.BulkSerialize(Ar);
+	if (Ar.IsLoading() && Grid.Cells.Num() != Grid.Extent.X * Grid.Extent.Y * Grid.Extent.Z) {
+		Ar.SetError();
+		Grid = FVoxelGrid();
+	}
+	return Ar;
+}
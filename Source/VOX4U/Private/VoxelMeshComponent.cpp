@@ -0,0 +1,97 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxelMeshComponent.h"
+#include <Engine/StaticMesh.h>
+#include <SceneView.h>
+#include "VoxelSectionSceneProxy.h"
+
+const FName UVoxelMeshComponent::DirectionSlotNames[6] = {
+	TEXT("Up"), TEXT("Down"), TEXT("Forward"), TEXT("Backward"), TEXT("Right"), TEXT("Left")
+};
+
+/**
+ * Scene proxy skips direction sections facing away from the view. A face
+ * pointing to +Z is visible only if the view is above the lowest face of the
+ * bounds, and so on, tested with view origin in local space.
+ */
+class FVoxelMeshSceneProxy : public FVoxelSectionSceneProxy
+{
+public:
+
+	FVoxelMeshSceneProxy(UVoxelMeshComponent* Component)
+		: FVoxelSectionSceneProxy(Component)
+	{
+	}
+
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+protected:
+
+	virtual bool IsSectionVisible(const FSceneView* View, int32 MaterialIndex) const override
+	{
+		if (!View->IsPerspectiveProjection()) return true;
+		const FVector Origin = GetLocalToWorld().InverseTransformPosition(View->ViewMatrices.GetViewOrigin());
+		const FBox Box = RenderData->Bounds.GetBox();
+		switch (MaterialIndex) {
+		case 0: return Origin.Z > Box.Min.Z;
+		case 1: return Origin.Z < Box.Max.Z;
+		case 2: return Origin.X > Box.Min.X;
+		case 3: return Origin.X < Box.Max.X;
+		case 4: return Origin.Y > Box.Min.Y;
+		case 5: return Origin.Y < Box.Max.Y;
+		default: return true;
+		}
+	}
+};
+
+UVoxelMeshComponent::UVoxelMeshComponent()
+	: bCullByDirection(true)
+	, MinCullTriangles(4096)
+{
+}
+
+FPrimitiveSceneProxy* UVoxelMeshComponent::CreateSceneProxy()
+{
+	UStaticMesh* Mesh = GetStaticMesh();
+	if (!bCullByDirection || !HasDirectionSections()
+		|| !Mesh->RenderData || Mesh->RenderData->LODResources.Num() == 0 || !Mesh->RenderData->IsInitialized()
+		|| Mesh->RenderData->LODResources[0].GetNumTriangles() < MinCullTriangles) {
+		return Super::CreateSceneProxy();
+	}
+	return new FVoxelMeshSceneProxy(this);
+}
+
+bool UVoxelMeshComponent::HasDirectionSections() const
+{
+	const UStaticMesh* Mesh = GetStaticMesh();
+	if (!Mesh || Mesh->StaticMaterials.Num() != ARRAY_COUNT(DirectionSlotNames)) {
+		return false;
+	}
+	for (int32 Index = 0; Index < ARRAY_COUNT(DirectionSlotNames); ++Index) {
+		if (Mesh->StaticMaterials[Index].MaterialSlotName != DirectionSlotNames[Index]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+#if WITH_EDITOR
+
+void UVoxelMeshComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	static const FName NAME_CullByDirection = FName(TEXT("bCullByDirection"));
+	static const FName NAME_MinCullTriangles = FName(TEXT("MinCullTriangles"));
+	if (PropertyChangedEvent.Property) {
+		const FName PropertyName = PropertyChangedEvent.Property->GetFName();
+		if (PropertyName == NAME_CullByDirection || PropertyName == NAME_MinCullTriangles) {
+			MarkRenderStateDirty();
+		}
+	}
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+
+#endif // WITH_EDITOR
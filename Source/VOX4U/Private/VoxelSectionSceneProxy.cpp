@@ -0,0 +1,47 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxelSectionSceneProxy.h"
+#include <Components/StaticMeshComponent.h>
+#include <SceneManagement.h>
+#include "VoxelStats.h"
+
+DEFINE_STAT(STAT_VoxelTrianglesSubmitted);
+DEFINE_STAT(STAT_VoxelTrianglesCulled);
+DEFINE_STAT(STAT_VoxelSectionSelection);
+
+FVoxelSectionSceneProxy::FVoxelSectionSceneProxy(UStaticMeshComponent* Component)
+	: FStaticMeshSceneProxy(Component, false)
+{
+}
+
+FPrimitiveViewRelevance FVoxelSectionSceneProxy::GetViewRelevance(const FSceneView* View) const
+{
+	//cached static draw lists would draw every section
+	FPrimitiveViewRelevance Result = FStaticMeshSceneProxy::GetViewRelevance(View);
+	Result.bStaticRelevance = false;
+	Result.bDynamicRelevance = true;
+	return Result;
+}
+
+void FVoxelSectionSceneProxy::GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const
+{
+	//cpu cost of drawing in dynamic path instead of cached static draw lists
+	SCOPE_CYCLE_COUNTER(STAT_VoxelSectionSelection);
+	if (!RenderData || RenderData->LODResources.Num() == 0) return;
+	const FStaticMeshLODResources& LODModel = RenderData->LODResources[0];
+	for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ++ViewIndex) {
+		if (!(VisibilityMap & (1 << ViewIndex))) continue;
+		for (int32 SectionIndex = 0; SectionIndex < LODModel.Sections.Num(); ++SectionIndex) {
+			const FStaticMeshSection& Section = LODModel.Sections[SectionIndex];
+			if (!IsSectionVisible(Views[ViewIndex], Section.MaterialIndex)) {
+				INC_DWORD_STAT_BY(STAT_VoxelTrianglesCulled, Section.NumTriangles);
+				continue;
+			}
+			FMeshBatch& Mesh = Collector.AllocateMesh();
+			if (GetMeshElement(0, 0, SectionIndex, SDPG_World, IsSelected(), false, Mesh)) {
+				Collector.AddMesh(ViewIndex, Mesh);
+				INC_DWORD_STAT_BY(STAT_VoxelTrianglesSubmitted, Section.NumTriangles);
+			}
+		}
+	}
+}
@@ -0,0 +1,29 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <StaticMeshResources.h>
+
+class UStaticMeshComponent;
+
+/**
+ * Static mesh scene proxy drawing selected sections of LOD 0 each view.
+ * Sections are chosen by material index and drawn in dynamic path, so
+ * selection can change every frame without recreating render state.
+ */
+class FVoxelSectionSceneProxy : public FStaticMeshSceneProxy
+{
+public:
+
+	FVoxelSectionSceneProxy(UStaticMeshComponent* Component);
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override;
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override;
+
+protected:
+
+	/** Draw section of material index in view */
+	virtual bool IsSectionVisible(const FSceneView* View, int32 MaterialIndex) const = 0;
+};
@@ -0,0 +1,12 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Stats/Stats.h>
+
+DECLARE_STATS_GROUP(TEXT("VOX4U"), STATGROUP_Voxel, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles submitted"), STAT_VoxelTrianglesSubmitted, STATGROUP_Voxel, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles culled"), STAT_VoxelTrianglesCulled, STATGROUP_Voxel, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Section selection"), STAT_VoxelSectionSelection, STATGROUP_Voxel, );
@@ -0,0 +1,189 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxelVisibility.h"
+#include "VoxelGrid.h"
+
+static const FIntVector Directions[6] = {
+	FIntVector(+0, +0, +1),	// Up
+	FIntVector(+0, +0, -1),	// Down
+	FIntVector(+1, +0, +0),	// Forward
+	FIntVector(-1, +0, +0),	// Backward
+	FIntVector(+0, +1, +0),	// Right
+	FIntVector(+0, -1, +0),	// Left
+};
+
+FVoxelVisibility::FVoxelVisibility()
+	: Size(ForceInitToZero)
+	, Solid()
+	, Exterior()
+	, Stack()
+{
+}
+
+/**
+ * Build
+ * @param InSize Model size
+ * @param Cells Solid cells
+ * @param Occluder Optional solid cells of adjacent models, may lie on the border
+ */
+void FVoxelVisibility::Build(const FIntVector& InSize, const TMap<FIntVector, uint8>& Cells, const TSet<FIntVector>* Occluder /*= nullptr*/)
+{
+	Size = InSize + FIntVector(2, 2, 2);
+	Solid.Init(false, Size.X * Size.Y * Size.Z);
+	for (const auto& Cell : Cells) {
+		const int32 Index = GetIndex(Cell.Key);
+		if (Index != INDEX_NONE) Solid[Index] = true;
+	}
+	if (Occluder) {
+		for (const FIntVector& Cell : *Occluder) {
+			const int32 Index = GetIndex(Cell);
+			if (Index != INDEX_NONE) Solid[Index] = true;
+		}
+	}
+	Fill();
+}
+
+/**
+ * Build
+ * @param InSize Model size
+ * @param Grid Solid cells
+ * @param Overlay Optional solid cells added over grid
+ * @param Removed Optional cells of grid removed by overlay
+ */
+void FVoxelVisibility::Build(const FIntVector& InSize, const FVoxelGrid& Grid, const TMap<FIntVector, uint8>* Overlay /*= nullptr*/, const TSet<FIntVector>* Removed /*= nullptr*/)
+{
+	Size = InSize + FIntVector(2, 2, 2);
+	Solid.Init(false, Size.X * Size.Y * Size.Z);
+	Grid.ForEach([&](const FIntVector& Cell, uint8 Value) {
+		const int32 Index = GetIndex(Cell);
+		if (Index != INDEX_NONE) Solid[Index] = true;
+	});
+	if (Removed) {
+		for (const FIntVector& Cell : *Removed) {
+			const int32 Index = GetIndex(Cell);
+			if (Index != INDEX_NONE) Solid[Index] = false;
+		}
+	}
+	if (Overlay) {
+		for (const auto& Cell : *Overlay) {
+			const int32 Index = GetIndex(Cell.Key);
+			if (Index != INDEX_NONE) Solid[Index] = true;
+		}
+	}
+	Fill();
+}
+
+/**
+ * Update
+ * Removed cells next to exterior space flood the space they open, which
+ * costs only cells entering it. Added cells may seal space anywhere, so
+ * exterior is filled again and compared with the one before.
+ */
+void FVoxelVisibility::Update(TArrayView<const FIntVector> Cells, TFunctionRef<bool(const FIntVector&)> IsSolid, TArray<FIntVector>& OutChanged)
+{
+	OutChanged.Reset();
+	if (!IsBuilt()) return;
+	bool bAdded = false;
+	Stack.Reset();
+	for (const FIntVector& Cell : Cells) {
+		const int32 Index = GetIndex(Cell);
+		if (Index == INDEX_NONE) continue;
+		const bool bSolid = IsSolid(Cell);
+		if (Solid[Index] == bSolid) continue;
+		Solid[Index] = bSolid;
+		bAdded |= bSolid;
+		if (!bSolid) Stack.Add(Cell);
+	}
+	if (bAdded) {
+		const TBitArray<> Before = Exterior;
+		Fill();
+		for (int32 Index = 0; Index < Exterior.Num(); ++Index) {
+			if (Exterior[Index] != Before[Index]) OutChanged.Add(GetCell(Index));
+		}
+		return;
+	}
+	//removed cells join exterior if any neighbour is exterior
+	const int32 NumRemoved = Stack.Num();
+	for (int32 i = 0; i < NumRemoved; ++i) {
+		const FIntVector Cell = Stack[i];
+		const int32 Index = GetIndex(Cell);
+		if (Exterior[Index]) continue;
+		for (const FIntVector& Direction : Directions) {
+			if (IsExterior(Cell + Direction)) {
+				Exterior[Index] = true;
+				OutChanged.Add(Cell);
+				Stack.Add(Cell);
+				break;
+			}
+		}
+	}
+	Stack.RemoveAt(0, NumRemoved, false);
+	Flood(&OutChanged);
+}
+
+void FVoxelVisibility::Fill()
+{
+	const FIntVector InSize = Size - FIntVector(2, 2, 2);
+	Exterior.Init(false, Solid.Num());
+	Stack.Reset();
+	//seed from every border cell, border is outside of model bounds
+	for (int32 z = -1; z <= InSize.Z; ++z) {
+		for (int32 y = -1; y <= InSize.Y; ++y) {
+			for (int32 x = -1; x <= InSize.X; ++x) {
+				if (x == -1 || y == -1 || z == -1 || x == InSize.X || y == InSize.Y || z == InSize.Z) {
+					const int32 Index = GetIndex(FIntVector(x, y, z));
+					if (!Solid[Index] && !Exterior[Index]) {
+						Exterior[Index] = true;
+						Stack.Add(FIntVector(x, y, z));
+					}
+				} else if (y != -1 && y != InSize.Y && z != -1 && z != InSize.Z) {
+					x = InSize.X - 1;
+				}
+			}
+		}
+	}
+	Flood(nullptr);
+}
+
+void FVoxelVisibility::Flood(TArray<FIntVector>* OutChanged)
+{
+	while (Stack.Num()) {
+		const FIntVector Cell = Stack.Pop(false);
+		for (const FIntVector& Direction : Directions) {
+			const int32 Index = GetIndex(Cell + Direction);
+			if (Index != INDEX_NONE && !Solid[Index] && !Exterior[Index]) {
+				Exterior[Index] = true;
+				Stack.Add(Cell + Direction);
+				if (OutChanged) OutChanged->Add(Cell + Direction);
+			}
+		}
+	}
+}
+
+bool FVoxelVisibility::IsExterior(const FIntVector& Cell) const
+{
+	const int32 Index = GetIndex(Cell);
+	return Index == INDEX_NONE || Exterior[Index];
+}
+
+bool FVoxelVisibility::IsVisible(const FIntVector& Cell) const
+{
+	for (const FIntVector& Direction : Directions) {
+		if (IsExterior(Cell + Direction)) return true;
+	}
+	return false;
+}
+
+int32 FVoxelVisibility::GetIndex(const FIntVector& Cell) const
+{
+	const FIntVector P = Cell + FIntVector(1, 1, 1);
+	if (P.X < 0 || P.Y < 0 || P.Z < 0 || Size.X <= P.X || Size.Y <= P.Y || Size.Z <= P.Z) {
+		return INDEX_NONE;
+	}
+	return (P.Z * Size.Y + P.Y) * Size.X + P.X;
+}
+
+FIntVector FVoxelVisibility::GetCell(int32 Index) const
+{
+	return FIntVector(Index % Size.X, Index / Size.X % Size.Y, Index / (Size.X * Size.Y)) - FIntVector(1, 1, 1);
+}
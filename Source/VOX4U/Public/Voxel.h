@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include <UObject/NoExportTypes.h>
+#include "VoxelGrid.h"
 #include "Voxel.generated.h"
 
 class UStaticMesh;
@@ -30,6 +31,7 @@ public:
 	UPROPERTY(EditDefaultsOnly, EditFixedSize, Category = Voxel)
 	TArray<UStaticMesh*> Mesh;
 
+	/** Cells written by import or edit, built from grid on demand and empty after load */
 	UPROPERTY(EditDefaultsOnly, Category = Voxel)
 	TMap<FIntVector, uint8> Voxel;
 
@@ -42,12 +44,40 @@ public:
 
 	UVoxel();
 
+	virtual void Serialize(FArchive& Ar) override;
+
+	virtual void PostLoad() override;
+
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+	/** Rebuild flat grid shared by components from cell map */
+	void BuildGrid();
+
+	/** Fill cell map from flat grid if it does not hold every cell */
+	void BuildCellMap();
+
+	/** Flat grid of cells, only source of cells in cooked data */
+	const FVoxelGrid& GetGrid() const { return *Grid; }
+
+	/** Reference to flat grid for components sharing it */
+	TSharedRef<const FVoxelGrid, ESPMode::ThreadSafe> GetSharedGrid() const { return Grid; }
+
 #if WITH_EDITOR
 
+	virtual void PreEditChange(UProperty* PropertyAboutToChange) override;
+
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
 
 	void CalcCellBounds();
 
 #endif // WITH_EDITOR
 
+private:
+
+	void SerializeCells(FArchive& Ar);
+
+private:
+
+	TSharedRef<FVoxelGrid, ESPMode::ThreadSafe> Grid;
+
 };
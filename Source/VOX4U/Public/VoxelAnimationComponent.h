@@ -0,0 +1,58 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Components/StaticMeshComponent.h>
+#include "VoxelAnimationComponent.generated.h"
+
+/**
+ * Voxel animation component
+ * Play static mesh imported as vox animation. Frame N is the section of
+ * material slot N and only the current frame section is drawn.
+ */
+UCLASS(ClassGroup = Rendering, meta = (BlueprintSpawnableComponent))
+class VOX4U_API UVoxelAnimationComponent : public UStaticMeshComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = VoxelAnimation)
+	float FramesPerSecond;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = VoxelAnimation)
+	bool bPlaying;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = VoxelAnimation)
+	int32 Frame;
+
+public:
+
+	UVoxelAnimationComponent();
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+
+	UFUNCTION(BlueprintCallable, Category = VoxelAnimation)
+	void SetFrame(int32 InFrame);
+
+	UFUNCTION(BlueprintCallable, Category = VoxelAnimation)
+	int32 GetFrame() const;
+
+	UFUNCTION(BlueprintCallable, Category = VoxelAnimation)
+	int32 GetNumFrames() const;
+
+	UFUNCTION(BlueprintCallable, Category = VoxelAnimation)
+	void Play();
+
+	UFUNCTION(BlueprintCallable, Category = VoxelAnimation)
+	void Stop();
+
+private:
+
+	/** Time since frame 0 while playing */
+	float Time;
+
+};
@@ -0,0 +1,126 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @struct FVoxelBitset
+ * Packed occupancy of cells in box from Min to Min + Extent, one bit per cell
+ * and every row along X padded to whole 64 bit words. Boolean operations
+ * between bitsets of same box run on words, two at once, over bounds of set
+ * cells only, and write changed cells to another bitset. Storage is kept by
+ * Init and Reset, so bitsets reused every frame never allocate.
+ */
+struct VOX4U_API FVoxelBitset
+{
+public:
+
+	FVoxelBitset();
+
+	FVoxelBitset(const FIntVector& InMin, const FIntVector& InExtent);
+
+	/** Set box and clear every cell */
+	void Init(const FIntVector& InMin, const FIntVector& InExtent);
+
+	/** Clear every cell, only words in bounds are written */
+	void Reset();
+
+	const FIntVector& GetMin() const { return Min; }
+
+	const FIntVector& GetExtent() const { return Extent; }
+
+	/** No cell set */
+	bool IsEmpty() const { return BoundsMax.X < BoundsMin.X; }
+
+	/** Cell is in box */
+	bool IsInside(const FIntVector& Cell) const
+	{
+		const FIntVector P = Cell - Min;
+		return 0 <= P.X && 0 <= P.Y && 0 <= P.Z && P.X < Extent.X && P.Y < Extent.Y && P.Z < Extent.Z;
+	}
+
+	/** Cell is set, false out of box */
+	bool Test(const FIntVector& Cell) const
+	{
+		if (!IsInside(Cell)) return false;
+		const FIntVector P = Cell - Min;
+		return ((Words[GetRow(P.Y, P.Z) + (P.X >> 6)] >> (P.X & 63)) & 1) != 0;
+	}
+
+	/** Set or clear cell, cells out of box are ignored */
+	void Set(const FIntVector& Cell, bool bValue = true);
+
+	/** Set cells with center in sphere, cell centers at integer coordinates */
+	void SetSphere(const FVector& Center, float Radius);
+
+	/** Set cells from BoxMin to BoxMax inclusive */
+	void SetBox(const FIntVector& BoxMin, const FIntVector& BoxMax);
+
+	/** Set cells of brush, OutChanged receives cells newly set */
+	void Union(const FVoxelBitset& Brush, FVoxelBitset& OutChanged);
+
+	/** Clear cells of brush, OutChanged receives cells cleared */
+	void Subtract(const FVoxelBitset& Brush, FVoxelBitset& OutChanged);
+
+	/** Clear cells out of brush, OutChanged receives cells cleared */
+	void Intersect(const FVoxelBitset& Brush, FVoxelBitset& OutChanged);
+
+	/** Call Func(const FIntVector& Cell) for every set cell in x, y, z order */
+	template <typename FunctionType>
+	void ForEach(FunctionType Func) const
+	{
+		if (IsEmpty()) return;
+		const int32 FirstWord = BoundsMin.X >> 6, LastWord = BoundsMax.X >> 6;
+		for (int32 Z = BoundsMin.Z; Z <= BoundsMax.Z; ++Z) {
+			for (int32 Y = BoundsMin.Y; Y <= BoundsMax.Y; ++Y) {
+				const uint64* Row = Words.GetData() + GetRow(Y, Z);
+				for (int32 Word = FirstWord; Word <= LastWord; ++Word) {
+					for (uint64 Bits = Row[Word]; Bits; Bits &= Bits - 1) {
+						Func(Min + FIntVector(Word * 64 + CountTrailingZeros(Bits), Y, Z));
+					}
+				}
+			}
+		}
+	}
+
+	/** Allocated size */
+	SIZE_T GetAllocatedSize() const { return Words.GetAllocatedSize(); }
+
+private:
+
+	/** First word of row */
+	int32 GetRow(int32 Y, int32 Z) const
+	{
+		return (Z * Extent.Y + Y) * WordsPerRow;
+	}
+
+	/** Set bits from X0 to X1 inclusive of row and grow bounds */
+	void SetSpan(int32 X0, int32 X1, int32 Y, int32 Z);
+
+	/** Grow bounds by box of box space cells, inclusive */
+	void AddBounds(const FIntVector& InMin, const FIntVector& InMax);
+
+	template <typename OpType>
+	void Combine(const FVoxelBitset& Brush, FVoxelBitset& OutChanged, const FIntVector& From, const FIntVector& To);
+
+	static int32 CountTrailingZeros(uint64 Bits)
+	{
+		const uint32 Low = (uint32)Bits;
+		return Low ? (int32)FMath::CountTrailingZeros(Low) : 32 + (int32)FMath::CountTrailingZeros((uint32)(Bits >> 32));
+	}
+
+private:
+
+	/** Min of box */
+	FIntVector Min;
+	/** Size of box */
+	FIntVector Extent;
+	/** Words of every row */
+	int32 WordsPerRow;
+	/** Box space bounds of set cells, inclusive and may hold cleared cells */
+	FIntVector BoundsMin;
+	FIntVector BoundsMax;
+	/** Bits of every row in y, z order, x along bits */
+	TArray<uint64> Words;
+};
@@ -4,11 +4,49 @@
 
 #include "CoreMinimal.h"
 #include <Components/PrimitiveComponent.h>
+#include "VoxelBitset.h"
+#include "VoxelConnectivity.h"
+#include "VoxelVisibility.h"
 #include "VoxelComponent.generated.h"
 
 class UInstancedStaticMeshComponent;
 class UStaticMesh;
 class UVoxel;
+class UVoxelComponent;
+
+/** Boolean operation between cells of component and brush */
+UENUM(BlueprintType)
+enum class EVoxelBooleanOp : uint8
+{
+	/** Add cells of brush, cells already there keep their value */
+	Union,
+	/** Remove cells of brush */
+	Subtract,
+	/** Remove cells out of brush */
+	Intersect,
+};
+
+/** Instance drawing cell */
+struct FVoxelInstance
+{
+	/** Index of mesh and instanced static mesh component */
+	int32 Mesh;
+	/** Index of instance */
+	int32 Index;
+};
+
+/** Cells cut off every anchor of voxel component */
+USTRUCT(BlueprintType)
+struct VOX4U_API FVoxelIsland
+{
+	GENERATED_BODY()
+
+	/** Cells and their values */
+	UPROPERTY(BlueprintReadOnly, Category = VoxelIsland)
+	TMap<FIntVector, uint8> Cell;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FVoxelIslandDetachedSignature, UVoxelComponent*, VoxelComponent, const FVoxelIsland&, Island);
 
 /**
  * Voxel component
@@ -26,17 +64,38 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = VoxelComponent)
 	bool bHideUnbeheld;
 
+	/** Also hide cells facing only sealed cavities, found by flood fill from outside */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = VoxelComponent)
+	bool bHideEnclosed;
+
 	UPROPERTY(EditAnywhere, EditFixedSize, BlueprintReadWrite, Category = VoxelComponent)
 	TArray<UStaticMesh*> Mesh;
 
-	UPROPERTY(EditAnywhere, EditFixedSize, BlueprintReadWrite, Category = VoxelComponent)
+	/** Cells added or changed by this component over cells shared by voxel asset */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = VoxelComponent)
 	TMap<FIntVector, uint8> Cell;
 
+	/** Cells of voxel asset removed by this component */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = VoxelComponent)
+	TSet<FIntVector> RemovedCell;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = VoxelComponent)
 	UVoxel* Voxel;
 
+	/** Track connected pieces and remove pieces cut off every anchor by removed cells */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = VoxelComponent)
+	bool bDetachIslands;
+
+	/** Cells holding pieces in place, bottom layer if empty */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = VoxelComponent)
+	TSet<FIntVector> AnchorCell;
+
 public:
 
+	/** Called with cells of every piece detached, after they are removed */
+	UPROPERTY(BlueprintAssignable, Category = VoxelComponent)
+	FVoxelIslandDetachedSignature OnIslandDetached;
+
 	UVoxelComponent();
 
 #if WITH_EDITOR
@@ -45,6 +104,8 @@ public:
 
 #endif // WITH_EDITOR
 
+	virtual void PostLoad() override;
+
 	void SetVoxel(class UVoxel* InVoxel, bool bForce = false);
 
 	const UVoxel* GetVoxel() const;
@@ -55,6 +116,54 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Voxel)
 	void ClearVoxel();
 
+	/** Cell value of component overlay or voxel asset, INDEX_NONE for empty cell */
+	int32 GetCell(const FIntVector& InVector) const;
+
+	/** Set cell of this component only and update instances around it */
+	UFUNCTION(BlueprintCallable, Category = Voxel)
+	bool SetCell(const FIntVector& InVector, uint8 Value);
+
+	/** Remove cell of this component only and update instances around it */
+	UFUNCTION(BlueprintCallable, Category = Voxel)
+	bool RemoveCell(const FIntVector& InVector);
+
+	/** Cells in voxel size, box of every brush, empty until first edit */
+	const FVoxelBitset& GetOccupancy() const;
+
+	/**
+	 * Combine cells with brush of box from 0 to voxel size and update instances
+	 * around changed cells only. Cells out of voxel size are never changed.
+	 * @param GetValue Value of every cell added by union
+	 * @param OutChanged Cells added or removed
+	 * @return Num of changed cells
+	 */
+	int32 Combine(EVoxelBooleanOp Op, const FVoxelBitset& Brush, TFunctionRef<uint8(const FIntVector&)> GetValue, TArray<FIntVector>& OutChanged);
+
+	/** Combine cells with cells whose center is in sphere, center in cell coordinate */
+	UFUNCTION(BlueprintCallable, Category = Voxel)
+	int32 CombineSphere(EVoxelBooleanOp Op, const FVector& Center, float Radius, uint8 Value, TArray<FIntVector>& OutChanged);
+
+	/** Combine cells with cells from BoxMin to BoxMax inclusive */
+	UFUNCTION(BlueprintCallable, Category = Voxel)
+	int32 CombineBox(EVoxelBooleanOp Op, const FIntVector& BoxMin, const FIntVector& BoxMax, uint8 Value, TArray<FIntVector>& OutChanged);
+
+	/** Combine cells with cells of voxel asset moved by offset, union takes values of asset */
+	UFUNCTION(BlueprintCallable, Category = Voxel)
+	int32 CombineVoxel(EVoxelBooleanOp Op, const UVoxel* InVoxel, const FIntVector& Offset, TArray<FIntVector>& OutChanged);
+
+	UFUNCTION(BlueprintCallable, Category = Voxel)
+	void SetDetachIslands(bool bInDetachIslands);
+
+	UFUNCTION(BlueprintCallable, Category = Voxel)
+	void SetAnchorCell(const TSet<FIntVector>& InAnchorCell);
+
+	/** Cell coordinate of location, inverse of voxel transform */
+	UFUNCTION(BlueprintCallable, Category = Voxel)
+	FVector GetCellCoordinate(const FVector& Location, bool bWorldSpace = false) const;
+
+	/** Cells shared with every component of same voxel asset */
+	const FVoxelGrid& GetGrid() const;
+
 	UFUNCTION(BlueprintCallable, Category = Voxel)
 	bool IsUnbeheldVolume(const FIntVector& InVector) const;
 
@@ -63,15 +172,88 @@ public:
 
 	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
 
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
 	const TArray<UInstancedStaticMeshComponent*>& GetInstancedStaticMeshComponent() const;
 
 private:
 
 	void InitVoxel();
 
+	void InitVisibility();
+
+	void InitOccupancy();
+
+	/** Drop occupancy and pieces, built again by next edit */
+	void ResetOccupancy();
+
+	void InitConnectivity();
+
+	/** Transform of cell instance relative to component */
+	FTransform GetCellTransform(const FIntVector& InVector) const;
+
+	/** Cell is not empty, from occupancy in voxel size once built */
+	bool IsSolid(const FIntVector& InVector) const;
+
+	/** Write cell to overlay without updating instances */
+	void WriteCell(const FIntVector& InVector, uint8 Value);
+
+	/** Erase cell from overlay without updating instances */
+	void EraseCell(const FIntVector& InVector);
+
+	/**
+	 * Remove pieces cut off every anchor by removed cells
+	 * @param InOutChanged Removed cells, cells of detached pieces are appended
+	 */
+	void DetachIslands(TArray<FIntVector>& InOutChanged);
+
+	/** Broadcast pieces detached since last call */
+	void BroadcastIslands();
+
+	/** Add, remove or switch instances of cells and their neighbours to match cells */
+	void UpdateInstances(TArrayView<const FIntVector> InVectors);
+
+	void UpdateInstance(const FIntVector& InVector);
+
+	void AddInstance(const FIntVector& InVector, int32 Value);
+
+	/** Remove instance of cell, last instance of its mesh moves into its index */
+	void RemoveInstance(const FIntVector& InVector);
+
 protected:
 
 	UPROPERTY()
 	TArray<UInstancedStaticMeshComponent*> InstancedStaticMeshComponents;
 
+	FVoxelVisibility Visibility;
+
+	/** Grid of voxel asset when voxel was set, kept while asset rebuilds its grid */
+	TSharedPtr<const FVoxelGrid, ESPMode::ThreadSafe> Grid;
+
+	/** Cells in voxel size, kept with cell overlay from first edit */
+	FVoxelBitset Occupancy;
+
+	/** Brush and changed cells of last boolean operation, kept to reuse storage */
+	FVoxelBitset BrushCells;
+	FVoxelBitset ChangedCells;
+
+	/** Instance of every drawn cell */
+	TMap<FIntVector, FVoxelInstance> CellInstance;
+
+	/** Cell of every instance of every mesh */
+	TArray<TArray<FIntVector>> InstanceCell;
+
+	/** Pieces of cells in voxel size, built if detaching islands */
+	FVoxelConnectivity Connectivity;
+
+	/** Pieces detached by last edit, kept to reuse storage */
+	TArray<TArray<FIntVector>> DetachedCells;
+	TArray<FVoxelIsland> DetachedIslands;
+
+	/** Cells of last single cell edit, kept to reuse storage */
+	TArray<FIntVector> EditedCells;
+
+	/** Cells entering or leaving exterior space by last edit, kept to reuse storage */
+	TArray<FIntVector> ExteriorCells;
+
 };
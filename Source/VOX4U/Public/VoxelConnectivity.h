@@ -0,0 +1,156 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelBitset.h"
+
+/**
+ * @struct FVoxelConnectivity
+ * Face connected pieces of cells in box of occupancy, labelled per cell and
+ * kept up to date by edits. Added cells join pieces of their neighbours, the
+ * smaller pieces relabelled into the largest. Removed cells start a search
+ * from every neighbour, one cell each in turn, and searches stop when all
+ * but one finish, so only pieces split off are walked whole. Pieces losing
+ * their last anchor cell are detached.
+ */
+struct VOX4U_API FVoxelConnectivity
+{
+public:
+
+	FVoxelConnectivity();
+
+	/**
+	 * Label every piece of occupancy
+	 * @param Occupancy Solid cells, box of every later edit
+	 * @param InAnchor Cells attaching pieces, in same box
+	 */
+	void Build(const FVoxelBitset& Occupancy, const FVoxelBitset& InAnchor);
+
+	/** Drop every label */
+	void Reset();
+
+	/** Labels are built */
+	bool IsBuilt() const { return 0 < Labels.Num(); }
+
+	/** Num of pieces */
+	int32 Num() const { return Pieces.Num() - FreeLabels.Num(); }
+
+	/** Label of piece of cell, INDEX_NONE for empty cell or cell out of box */
+	int32 GetLabel(const FIntVector& Cell) const
+	{
+		const int32 Index = GetIndex(Cell);
+		return Index != INDEX_NONE ? FMath::Max(Labels[Index], (int32)INDEX_NONE) : INDEX_NONE;
+	}
+
+	/** Piece of cell holds an anchor cell */
+	bool IsAnchored(const FIntVector& Cell) const
+	{
+		const int32 Label = GetLabel(Cell);
+		return Label != INDEX_NONE && 0 < Pieces[Label].Anchors;
+	}
+
+	/** Label cells set in occupancy, cells out of box are ignored */
+	void Add(TArrayView<const FIntVector> Cells);
+
+	/**
+	 * Unlabel cells cleared in occupancy, cells out of box are ignored
+	 * @param OutDetached Cells of every piece that held an anchor before and
+	 * none after, unlabelled and left for caller to clear
+	 */
+	void Remove(TArrayView<const FIntVector> Cells, TArray<TArray<FIntVector>>& OutDetached);
+
+	/** Allocated size */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+
+	struct FPiece
+	{
+		/** Num of cells */
+		int32 Num;
+		/** Num of anchor cells */
+		int32 Anchors;
+		/** Removed cells of current edit were in piece */
+		bool bTouched;
+		/** Piece held an anchor before current edit */
+		bool bWasAnchored;
+	};
+
+	/** Search from one neighbour of removed cells, searches that met share root */
+	struct FFront
+	{
+		int32 Parent;
+		/** Members not finished, counted on root */
+		int32 Active;
+		/** Label of piece split off, on root */
+		int32 Label;
+		/** Detached piece in output, on root */
+		int32 Detached;
+		int32 Anchors;
+		/** Cells claimed, searched up to Head */
+		int32 Head;
+		TArray<int32> Cells;
+	};
+
+	/** Index of cell in labels padded by one on every side, INDEX_NONE out of box */
+	int32 GetIndex(const FIntVector& Cell) const
+	{
+		const FIntVector P = Cell - Min;
+		if (P.X < 0 || P.Y < 0 || P.Z < 0 || Extent.X <= P.X || Extent.Y <= P.Y || Extent.Z <= P.Z) {
+			return INDEX_NONE;
+		}
+		return (P.X + 1) + (P.Y + 1) * StrideY + (P.Z + 1) * StrideZ;
+	}
+
+	FIntVector GetCell(int32 Index) const
+	{
+		const int32 Z = Index / StrideZ, Y = Index % StrideZ / StrideY, X = Index % StrideY;
+		return Min + FIntVector(X - 1, Y - 1, Z - 1);
+	}
+
+	bool IsAnchor(int32 Index) const { return Anchor.Test(GetCell(Index)); }
+
+	int32 NewLabel();
+
+	void FreeLabel(int32 Label);
+
+	/** Relabel piece of start cell to label, returns num of cells */
+	int32 Flood(int32 Start, int32 Label, TArray<FIntVector>* OutCells = nullptr);
+
+	/** Find pieces label falls into from seeds next to removed cells */
+	void Split(int32 Label, const int32* InSeeds, int32 NumSeeds, TArray<TArray<FIntVector>>& OutDetached);
+
+	/** Claim cell for front */
+	void Claim(int32 Front, int32 Index);
+
+	int32 FindRoot(int32 Front);
+
+	/** Label of cell claimed by front, or front of such label */
+	static int32 GetFrontLabel(int32 Front) { return -2 - Front; }
+
+private:
+
+	/** Min of box */
+	FIntVector Min;
+	/** Size of box */
+	FIntVector Extent;
+	/** Index step along Y and Z */
+	int32 StrideY;
+	int32 StrideZ;
+	/** Index step to every face neighbour */
+	int32 Offsets[6];
+	/** Label of every cell, INDEX_NONE for empty cell or padding and below for searches */
+	TArray<int32> Labels;
+	/** Piece of every label */
+	TArray<FPiece> Pieces;
+	/** Labels of no piece */
+	TArray<int32> FreeLabels;
+	/** Cells attaching pieces */
+	FVoxelBitset Anchor;
+	/** Scratch of edits, kept to reuse storage */
+	TArray<int32> Seeds;
+	TArray<int32> Touched;
+	TArray<int32> Stack;
+	TArray<FFront> Fronts;
+};
@@ -0,0 +1,62 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Engine/AssetUserData.h>
+#include "VoxelDistanceFieldUserData.generated.h"
+
+class FDistanceFieldVolumeData;
+class UStaticMesh;
+
+/**
+ * Voxel distance field user data
+ * Mesh distance field computed from cells, saved with the static mesh. The
+ * mesh is built with distance field resolution scale 0, so render data built
+ * or loaded holds an empty field and this one replaces it.
+ */
+UCLASS()
+class VOX4U_API UVoxelDistanceFieldUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+
+	UVoxelDistanceFieldUserData();
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeOwner() override;
+#endif
+
+	/** Keep copy of distance field */
+	void SetDistanceField(const FDistanceFieldVolumeData& DistanceField);
+
+	/** Replace distance field of first LOD render data of mesh */
+	void ApplyTo(UStaticMesh* StaticMesh) const;
+
+private:
+
+	UPROPERTY()
+	FIntVector Size;
+
+	UPROPERTY()
+	FBox LocalBoundingBox;
+
+	UPROPERTY()
+	FVector2D DistanceMinMax;
+
+	UPROPERTY()
+	bool bMeshWasClosed;
+
+	UPROPERTY()
+	bool bBuiltAsIfTwoSided;
+
+	UPROPERTY()
+	bool bMeshWasPlane;
+
+	UPROPERTY()
+	TArray<uint8> CompressedDistanceFieldVolume;
+
+};
@@ -0,0 +1,92 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @struct FVoxelGrid
+ * Read only dense cell grid over cell bounds. Stores value + 1 per cell
+ * and 0 for empty cells, so cooked data loads as one flat block.
+ */
+struct VOX4U_API FVoxelGrid
+{
+public:
+
+	FVoxelGrid();
+
+	/** Create grid from cell map */
+	explicit FVoxelGrid(const TMap<FIntVector, uint8>& InCells);
+
+	/** Create grid from value + 1 or 0 of every cell in bounds, empty if size does not match */
+	FVoxelGrid(const FIntVector& InMin, const FIntVector& InExtent, TArray<uint8>&& InCells);
+
+	/** Num of cells */
+	int32 Num() const { return NumCells; }
+
+	/** Min of cell bounds */
+	const FIntVector& GetMin() const { return Min; }
+
+	/** Size of cell bounds */
+	const FIntVector& GetExtent() const { return Extent; }
+
+	/** Value + 1 or 0 of every cell in x, y, z order */
+	const TArray<uint8>& GetCells() const { return Cells; }
+
+	/** Cell value or INDEX_NONE for empty cell */
+	int32 Get(const FIntVector& Cell) const
+	{
+		const int32 Index = GetIndex(Cell);
+		return Index != INDEX_NONE && Cells[Index] ? Cells[Index] - 1 : INDEX_NONE;
+	}
+
+	/** Cell is not empty */
+	bool Contains(const FIntVector& Cell) const
+	{
+		return Get(Cell) != INDEX_NONE;
+	}
+
+	/** Call Func(const FIntVector& Cell, uint8 Value) for every cell */
+	template <typename FunctionType>
+	void ForEach(FunctionType Func) const
+	{
+		int32 Index = 0;
+		FIntVector P;
+		for (P.Z = Min.Z; P.Z < Min.Z + Extent.Z; ++P.Z) {
+			for (P.Y = Min.Y; P.Y < Min.Y + Extent.Y; ++P.Y) {
+				for (P.X = Min.X; P.X < Min.X + Extent.X; ++P.X, ++Index) {
+					if (Cells[Index]) {
+						Func(P, (uint8)(Cells[Index] - 1));
+					}
+				}
+			}
+		}
+	}
+
+	/** Allocated size */
+	SIZE_T GetAllocatedSize() const { return Cells.GetAllocatedSize(); }
+
+	friend VOX4U_API FArchive& operator<<(FArchive& Ar, FVoxelGrid& Grid);
+
+private:
+
+	int32 GetIndex(const FIntVector& Cell) const
+	{
+		const FIntVector P = Cell - Min;
+		if (P.X < 0 || P.Y < 0 || P.Z < 0 || Extent.X <= P.X || Extent.Y <= P.Y || Extent.Z <= P.Z) {
+			return INDEX_NONE;
+		}
+		return (P.Z * Extent.Y + P.Y) * Extent.X + P.X;
+	}
+
+private:
+
+	/** Min of cell bounds */
+	FIntVector Min;
+	/** Size of cell bounds */
+	FIntVector Extent;
+	/** Num of not empty cells */
+	int32 NumCells;
+	/** Value + 1 or 0 in x, y, z order */
+	TArray<uint8> Cells;
+};
@@ -0,0 +1,47 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Components/StaticMeshComponent.h>
+#include "VoxelMeshComponent.generated.h"
+
+/**
+ * Voxel mesh component
+ * Draw static mesh imported with faces grouped by direction. Sections facing
+ * away from the view can not be seen and are skipped before submission.
+ */
+UCLASS(ClassGroup = Rendering, meta = (BlueprintSpawnableComponent))
+class VOX4U_API UVoxelMeshComponent : public UStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Material slot names of direction sections, Up, Down, Forward, Backward, Right and Left */
+	static const FName DirectionSlotNames[6];
+
+protected:
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = VoxelMesh)
+	bool bCullByDirection;
+
+	/** Meshes with less triangles stay in static draw lists, culling saves less than dynamic path costs */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = VoxelMesh, meta = (ClampMin = "0", EditCondition = "bCullByDirection"))
+	int32 MinCullTriangles;
+
+public:
+
+	UVoxelMeshComponent();
+
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+
+	/** Mesh has the six direction material slots */
+	UFUNCTION(BlueprintCallable, Category = VoxelMesh)
+	bool HasDirectionSections() const;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif // WITH_EDITOR
+
+};
@@ -0,0 +1,67 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FVoxelGrid;
+
+/**
+ * @struct FVoxelVisibility
+ * Empty space reachable from outside of model bounds by flood fill.
+ * Sealed cavities are not reachable and can be treated as solid. Solid cells
+ * are kept, so edits flood only space they open, and fill again only when
+ * cells are added.
+ */
+struct VOX4U_API FVoxelVisibility
+{
+public:
+
+	FVoxelVisibility();
+
+	/** Flood fill empty cells of grid [0, InSize) from one cell thick border around it */
+	void Build(const FIntVector& InSize, const TMap<FIntVector, uint8>& Cells, const TSet<FIntVector>* Occluder = nullptr);
+
+	/** Flood fill empty cells of flat grid with optional overlay cells */
+	void Build(const FIntVector& InSize, const FVoxelGrid& Grid, const TMap<FIntVector, uint8>* Overlay = nullptr, const TSet<FIntVector>* Removed = nullptr);
+
+	/** Built by either build */
+	bool IsBuilt() const { return 0 < Exterior.Num(); }
+
+	/**
+	 * Update solid cells and exterior space after edit
+	 * @param Cells Changed cells, cells out of grid and border are ignored
+	 * @param IsSolid Cell is solid after edit
+	 * @param OutChanged Cells entering or leaving exterior space
+	 */
+	void Update(TArrayView<const FIntVector> Cells, TFunctionRef<bool(const FIntVector&)> IsSolid, TArray<FIntVector>& OutChanged);
+
+	/** Empty cell connected to outside of model, cells out of bounds are always exterior */
+	bool IsExterior(const FIntVector& Cell) const;
+
+	/** Any face of cell can be seen from outside of model */
+	bool IsVisible(const FIntVector& Cell) const;
+
+private:
+
+	/** Flood fill exterior from border over solid cells */
+	void Fill();
+
+	/** Flood exterior from cells on stack */
+	void Flood(TArray<FIntVector>* OutChanged);
+
+	int32 GetIndex(const FIntVector& Cell) const;
+
+	FIntVector GetCell(int32 Index) const;
+
+private:
+
+	/** Grid size including border */
+	FIntVector Size;
+	/** Solid cells, may lie on border */
+	TBitArray<> Solid;
+	/** Reachable empty cells */
+	TBitArray<> Exterior;
+	/** Cells to flood from, kept to reuse storage */
+	TArray<FIntVector> Stack;
+};
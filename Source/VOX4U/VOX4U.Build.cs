@@ -30,6 +30,8 @@ public class VOX4U : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"RenderCore",
+				"RHI",
 				"Slate",
 				"SlateCore"
 			}
@@ -0,0 +1,280 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VertexCacheOptimizer.h"
+#include <RawMesh.h>
+#include "VoxImportStats.h"
+
+namespace
+{
+	const int32 MaxCacheSize = 32;
+	const float CacheDecayPower = 1.5f;
+	const float LastTriScore = 0.75f;
+	const float ValenceBoostScale = 2.f;
+	const float ValenceBoostPower = 0.5f;
+
+	struct FVertexData
+	{
+		/** Position in LRU cache or INDEX_NONE */
+		int32 CachePosition;
+		/** Triangles not added yet */
+		int32 NumActiveTriangles;
+		/** Offset of triangles in adjacency */
+		int32 FirstTriangle;
+		float Score;
+	};
+
+	float ComputeVertexScore(const FVertexData& Vertex)
+	{
+		if (Vertex.NumActiveTriangles == 0) {
+			return -1.f;
+		}
+		float Score = 0.f;
+		if (Vertex.CachePosition < 0) {
+			//not in cache
+		} else if (Vertex.CachePosition < 3) {
+			//used by last triangle, fixed score to not favour any of its vertices
+			Score = LastTriScore;
+		} else {
+			const float Scaler = 1.f / (MaxCacheSize - 3);
+			Score = FMath::Pow(1.f - (Vertex.CachePosition - 3) * Scaler, CacheDecayPower);
+		}
+		//boost vertices with few triangles left to get rid of lone triangles
+		Score += ValenceBoostScale * FMath::Pow((float)Vertex.NumActiveTriangles, -ValenceBoostPower);
+		return Score;
+	}
+
+	/** Permute per wedge array by face order, empty arrays stay empty */
+	template<typename T>
+	void PermuteWedges(TArray<T>& Wedges, const TArray<int32>& FaceOrder)
+	{
+		if (Wedges.Num() == 0) return;
+		TArray<T> Result;
+		Result.Reserve(Wedges.Num());
+		for (int32 Face : FaceOrder) {
+			Result.Add(Wedges[Face * 3 + 0]);
+			Result.Add(Wedges[Face * 3 + 1]);
+			Result.Add(Wedges[Face * 3 + 2]);
+		}
+		Wedges = MoveTemp(Result);
+	}
+
+	/** Permute per face array by face order, empty arrays stay empty */
+	template<typename T>
+	void PermuteFaces(TArray<T>& Faces, const TArray<int32>& FaceOrder)
+	{
+		if (Faces.Num() == 0) return;
+		TArray<T> Result;
+		Result.Reserve(Faces.Num());
+		for (int32 Face : FaceOrder) {
+			Result.Add(Faces[Face]);
+		}
+		Faces = MoveTemp(Result);
+	}
+}
+
+void FVertexCacheOptimizer::Optimize(FRawMesh& RawMesh)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_VertexCache);
+	const int32 NumFaces = RawMesh.WedgeIndices.Num() / 3;
+	if (NumFaces == 0 || RawMesh.FaceMaterialIndices.Num() != NumFaces) return;
+
+	//faces of each material stay together, groups in order of first appearance
+	TArray<int32> Materials;
+	TMap<int32, TArray<int32>> MaterialFaces;
+	for (int32 Face = 0; Face < NumFaces; ++Face) {
+		const int32 MaterialIndex = RawMesh.FaceMaterialIndices[Face];
+		if (!MaterialFaces.Contains(MaterialIndex)) {
+			Materials.Add(MaterialIndex);
+		}
+		MaterialFaces.FindOrAdd(MaterialIndex).Add(Face);
+	}
+
+	//engine reorders smaller sections again when mesh is built
+	bool bReordered = false;
+	TArray<int32> FaceOrder;
+	FaceOrder.Reserve(NumFaces);
+	for (int32 MaterialIndex : Materials) {
+		const TArray<int32>& Faces = MaterialFaces[MaterialIndex];
+		if (Faces.Num() < EngineOptimizedTriangles) {
+			FaceOrder.Append(Faces);
+			continue;
+		}
+		bReordered = true;
+		TArray<uint32> Indices;
+		Indices.Reserve(Faces.Num() * 3);
+		for (int32 Face : Faces) {
+			Indices.Add(RawMesh.WedgeIndices[Face * 3 + 0]);
+			Indices.Add(RawMesh.WedgeIndices[Face * 3 + 1]);
+			Indices.Add(RawMesh.WedgeIndices[Face * 3 + 2]);
+		}
+		TArray<int32> TriangleOrder;
+		OptimizeTriangles(Indices, RawMesh.VertexPositions.Num(), TriangleOrder);
+		for (int32 Triangle : TriangleOrder) {
+			FaceOrder.Add(Faces[Triangle]);
+		}
+	}
+	if (!bReordered) return;
+
+	PermuteWedges(RawMesh.WedgeIndices, FaceOrder);
+	PermuteWedges(RawMesh.WedgeTangentX, FaceOrder);
+	PermuteWedges(RawMesh.WedgeTangentY, FaceOrder);
+	PermuteWedges(RawMesh.WedgeTangentZ, FaceOrder);
+	for (int32 UVIndex = 0; UVIndex < MAX_MESH_TEXTURE_COORDS; ++UVIndex) {
+		PermuteWedges(RawMesh.WedgeTexCoords[UVIndex], FaceOrder);
+	}
+	PermuteWedges(RawMesh.WedgeColors, FaceOrder);
+	PermuteFaces(RawMesh.FaceMaterialIndices, FaceOrder);
+	PermuteFaces(RawMesh.FaceSmoothingMasks, FaceOrder);
+
+	//vertex positions in order of first use, unused positions are dropped
+	TArray<int32> Remap;
+	Remap.Init(INDEX_NONE, RawMesh.VertexPositions.Num());
+	TArray<FVector> VertexPositions;
+	VertexPositions.Reserve(RawMesh.VertexPositions.Num());
+	for (uint32& Index : RawMesh.WedgeIndices) {
+		if (Remap[Index] == INDEX_NONE) {
+			Remap[Index] = VertexPositions.Add(RawMesh.VertexPositions[Index]);
+		}
+		Index = Remap[Index];
+	}
+	RawMesh.VertexPositions = MoveTemp(VertexPositions);
+}
+
+void FVertexCacheOptimizer::OptimizeTriangles(const TArray<uint32>& Indices, int32 NumVertices, TArray<int32>& OutTriangleOrder)
+{
+	const int32 NumTriangles = Indices.Num() / 3;
+	OutTriangleOrder.Reset(NumTriangles);
+
+	TArray<FVertexData> Vertices;
+	Vertices.SetNumZeroed(NumVertices);
+	for (uint32 Index : Indices) {
+		++Vertices[Index].NumActiveTriangles;
+	}
+	int32 Offset = 0;
+	for (FVertexData& Vertex : Vertices) {
+		Vertex.CachePosition = INDEX_NONE;
+		Vertex.FirstTriangle = Offset;
+		Offset += Vertex.NumActiveTriangles;
+	}
+	//triangles of each vertex, active ones are kept in front
+	TArray<int32> Adjacency;
+	Adjacency.SetNumUninitialized(Offset);
+	{
+		TArray<int32> Count;
+		Count.SetNumZeroed(NumVertices);
+		for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle) {
+			for (int32 Corner = 0; Corner < 3; ++Corner) {
+				const uint32 Index = Indices[Triangle * 3 + Corner];
+				Adjacency[Vertices[Index].FirstTriangle + Count[Index]++] = Triangle;
+			}
+		}
+	}
+	for (FVertexData& Vertex : Vertices) {
+		Vertex.Score = ComputeVertexScore(Vertex);
+	}
+	TArray<float> TriangleScores;
+	TriangleScores.SetNumUninitialized(NumTriangles);
+	TBitArray<> Added(false, NumTriangles);
+	for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle) {
+		TriangleScores[Triangle] = Vertices[Indices[Triangle * 3 + 0]].Score + Vertices[Indices[Triangle * 3 + 1]].Score + Vertices[Indices[Triangle * 3 + 2]].Score;
+	}
+
+	uint32 Cache[MaxCacheSize + 3];
+	int32 CacheSize = 0;
+	int32 BestTriangle = INDEX_NONE;
+	int32 SearchStart = 0;
+	while (OutTriangleOrder.Num() < NumTriangles) {
+		if (BestTriangle == INDEX_NONE) {
+			//no candidate around cache, continue with best of remaining triangles
+			float BestScore = -1.f;
+			for (int32 Triangle = SearchStart; Triangle < NumTriangles; ++Triangle) {
+				if (Added[Triangle]) {
+					if (Triangle == SearchStart) ++SearchStart;
+					continue;
+				}
+				if (BestScore < TriangleScores[Triangle]) {
+					BestScore = TriangleScores[Triangle];
+					BestTriangle = Triangle;
+				}
+			}
+		}
+		check(BestTriangle != INDEX_NONE);
+		Added[BestTriangle] = true;
+		OutTriangleOrder.Add(BestTriangle);
+
+		//emit triangle and move its vertices to front of cache
+		uint32 NewCache[MaxCacheSize + 3];
+		int32 NewCacheSize = 0;
+		for (int32 Corner = 0; Corner < 3; ++Corner) {
+			const uint32 Index = Indices[BestTriangle * 3 + Corner];
+			NewCache[NewCacheSize++] = Index;
+			FVertexData& Vertex = Vertices[Index];
+			int32* Triangles = &Adjacency[Vertex.FirstTriangle];
+			for (int32 i = 0; i < Vertex.NumActiveTriangles; ++i) {
+				if (Triangles[i] == BestTriangle) {
+					Triangles[i] = Triangles[--Vertex.NumActiveTriangles];
+					Triangles[Vertex.NumActiveTriangles] = BestTriangle;
+					break;
+				}
+			}
+		}
+		for (int32 i = 0; i < CacheSize; ++i) {
+			const uint32 Index = Cache[i];
+			if (Index != NewCache[0] && Index != NewCache[1] && Index != NewCache[2]) {
+				NewCache[NewCacheSize++] = Index;
+			}
+		}
+		CacheSize = FMath::Min(NewCacheSize, MaxCacheSize);
+		//vertices pushed out of cache
+		for (int32 i = CacheSize; i < NewCacheSize; ++i) {
+			Vertices[NewCache[i]].CachePosition = INDEX_NONE;
+			Vertices[NewCache[i]].Score = ComputeVertexScore(Vertices[NewCache[i]]);
+		}
+		FMemory::Memcpy(Cache, NewCache, CacheSize * sizeof(uint32));
+
+		//rescore vertices in cache and their triangles, pick next from them
+		for (int32 i = 0; i < CacheSize; ++i) {
+			FVertexData& Vertex = Vertices[Cache[i]];
+			Vertex.CachePosition = i;
+			const float Delta = ComputeVertexScore(Vertex) - Vertex.Score;
+			Vertex.Score += Delta;
+			for (int32 j = 0; j < Vertex.NumActiveTriangles; ++j) {
+				TriangleScores[Adjacency[Vertex.FirstTriangle + j]] += Delta;
+			}
+		}
+		for (int32 i = CacheSize; i < NewCacheSize; ++i) {
+			const FVertexData& Vertex = Vertices[NewCache[i]];
+			for (int32 j = 0; j < Vertex.NumActiveTriangles; ++j) {
+				const int32 Triangle = Adjacency[Vertex.FirstTriangle + j];
+				TriangleScores[Triangle] = Vertices[Indices[Triangle * 3 + 0]].Score + Vertices[Indices[Triangle * 3 + 1]].Score + Vertices[Indices[Triangle * 3 + 2]].Score;
+			}
+		}
+		BestTriangle = INDEX_NONE;
+		float BestScore = -1.f;
+		for (int32 i = 0; i < CacheSize; ++i) {
+			const FVertexData& Vertex = Vertices[Cache[i]];
+			for (int32 j = 0; j < Vertex.NumActiveTriangles; ++j) {
+				const int32 Triangle = Adjacency[Vertex.FirstTriangle + j];
+				if (!Added[Triangle] && BestScore < TriangleScores[Triangle]) {
+					BestScore = TriangleScores[Triangle];
+					BestTriangle = Triangle;
+				}
+			}
+		}
+	}
+}
+
+int32 FVertexCacheOptimizer::CountCacheMisses(const TArray<uint32>& Indices, int32 CacheSize /*= FifoCacheSize*/)
+{
+	TArray<uint32> Fifo;
+	Fifo.Init(MAX_uint32, CacheSize);
+	int32 Head = 0;
+	int32 Misses = 0;
+	for (uint32 Index : Indices) {
+		if (Fifo.Contains(Index)) continue;
+		Fifo[Head] = Index;
+		Head = (Head + 1) % CacheSize;
+		++Misses;
+	}
+	return Misses;
+}
@@ -0,0 +1,31 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRawMesh;
+
+/**
+ * @struct FVertexCacheOptimizer
+ * Reorder triangles of raw mesh for post transform vertex cache and vertices
+ * for fetch locality.
+ * @see https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+ */
+struct FVertexCacheOptimizer
+{
+	/** Size of simulated FIFO cache to compute average cache miss ratio */
+	static const int32 FifoCacheSize = 16;
+
+	/** Engine build cache optimizes index buffer of sections with less triangles */
+	static const int32 EngineOptimizedTriangles = 50000;
+
+	/** Reorder faces of each material group too large for engine build then vertex positions by first use */
+	static void Optimize(FRawMesh& RawMesh);
+
+	/** Get triangle order of index list with linear speed vertex cache optimisation */
+	static void OptimizeTriangles(const TArray<uint32>& Indices, int32 NumVertices, TArray<int32>& OutTriangleOrder);
+
+	/** Count vertex transforms of index list through FIFO cache, divide by triangles to get ACMR */
+	static int32 CountCacheMisses(const TArray<uint32>& Indices, int32 CacheSize = FifoCacheSize);
+};
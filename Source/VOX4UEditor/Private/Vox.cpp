@@ -2,11 +2,23 @@
 
 #include "Vox.h"
 #include <Engine/Texture2D.h>
+#include <HAL/IConsoleManager.h>
+#include <Misc/SecureHash.h>
 #include "MonotoneMesh.h"
+#include "VertexCacheOptimizer.h"
+#include "VoxCoreAdapter.h"
 #include "VoxImportOption.h"
+#include "VoxImportStats.h"
+#include "VoxelVisibility.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogVox, Log, All)
 
+/**
+ * Version of generated mesh data. Change when mesh generation output changes
+ * to invalidate hashes stored in imported assets.
+ */
+static const uint32 VoxMeshVersion = 4;
+
 /**
  * MagicaVoxel default palette
  */
@@ -54,144 +66,22 @@ FVox::FVox(const FString& Filename, FArchive& Ar, const UVoxImportOption* Import
  */
 bool FVox::Import(FArchive& Ar, const UVoxImportOption* ImportOption)
 {
-	Ar.Serialize(MagicNumber, 4);
-
-	if (0 != FCStringAnsi::Strncmp("VOX ", MagicNumber, 4)) {
-		UE_LOG(LogVox, Error, TEXT("not a vox format"));
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_Parse);
+	VoxCore::VoxFile File;
+	if (!FVoxCoreAdapter::ReadVox(Ar, File)) {
 		return false;
 	}
-	UE_LOG(LogVox, Verbose, TEXT("MAGIC NUMBER: %s"), &MagicNumber);
-
-	Ar << VersionNumber;
+	FCStringAnsi::Strncpy(MagicNumber, "VOX ", 5);
+	VersionNumber = File.Version;
 	UE_LOG(LogVox, Display, TEXT("VERSION NUMBER: %d"), VersionNumber);
 
-	if (150 < VersionNumber) {
-		UE_LOG(LogVox, Error, TEXT("unsupported version."));
-		return false;
+	//every model is merged to single mesh of last model size
+	for (const VoxCore::VoxModel& Model : File.Models) {
+		Size = FVoxCoreAdapter::GetSize(Model, ImportOption);
+		FVoxCoreAdapter::GetCells(Model, ImportOption, Voxel);
+		UE_LOG(LogVox, Display, TEXT("SIZE: %s XYZI: NumVoxels=%d"), *Size.ToString(), (int32)Model.Cells.size());
 	}
-
-	ANSICHAR ChunkId[5] = { 0, };
-	uint32 SizeOfChunkContents;
-	uint32 TotalSizeOfChildrenChunks;
-
-	do {
-		Ar.Serialize(ChunkId, 4);
-		Ar << SizeOfChunkContents;
-		Ar << TotalSizeOfChildrenChunks;
-		if (0 == FCStringAnsi::Strncmp("MAIN", ChunkId, 4)) {
-			UE_LOG(LogVox, Display, TEXT("MAIN: "));
-		} else if (0 == FCStringAnsi::Strncmp("PACK", ChunkId, 4)) {
-			//apparently this is obsolete and not used when there is scene with multiple models
-			UE_LOG(LogVox, Display, TEXT("PACK:"));
-			int NumModels;
-			Ar << NumModels;
-			UE_LOG(LogVox, Display, TEXT("      NumModels %d"), NumModels);
-		}
-		//nTRN = transform Node Chunk : "nTRN". we use it to read scene model name
-		else if (0 == FCStringAnsi::Strncmp("nTRN", ChunkId, 4)) {
-			/*
-			int32	: node id
-			DICT	: node attributes
-				  (_name : string)
-				  (_hidden : 0/1)
-			int32 	: child node id
-			int32 	: reserved id (must be -1)
-			int32	: layer id
-			int32	: num of frames (must be 1)
-
-			// for each frame
-			{
-			DICT	: frame attributes
-				  (_r : int8) ROTATION, see (c)
-				  (_t : int32x3) translation
-			}xN
-			*/
-			int64 posStart = Ar.Tell();
-			int32 nodeId, childId, reserverdId, layerId, frames = -1;
-			Ar << nodeId;
-			UE_LOG(LogVox, Display, TEXT("transform chunk Id: %d"), nodeId);
-			TMap<FString, FString> attribs = ReadVoxDictionary(Ar);
-			if (attribs.Num()>0){
-				FString chunkIdStr;
-				chunkIdStr.AppendChars(ANSI_TO_TCHAR(ChunkId), 5);//this is not chunk id we are looking for..
-			
-				FString modelName;							
-				modelName = *attribs.Find("_name");
-				//chunkNames.Add(chunkIdStr, modelName);
-			}
-			//read some more
-			Ar << childId << reserverdId << layerId << frames;			
-			UE_LOG(LogVox, Display, TEXT("childId: %d"), childId);
-			//not really interested in frame attributes but need to read them anyways
-			for (int i = 0; i < frames; i++) {
-				TMap<FString, FString> frameAttrib = ReadVoxDictionary(Ar);								
-			}
-			int64 posEnd = Ar.Tell();
-			int bytesRead = posEnd - posStart;
-			int bytesRemaining = SizeOfChunkContents - bytesRead;
-			
-			//debug- consume rest of remaining bytes and don't crash
-			uint8 byte;
-			for (int i = 0; i < bytesRemaining; ++i) {
-				Ar << byte;
-			}
-			
-		}
-		else if (0 == FCStringAnsi::Strncmp("SIZE", ChunkId, 4)) {
-			Ar << Size.X << Size.Y << Size.Z;
-			if (ImportOption->bImportXForward) {
-				int32 temp = Size.X;
-				Size.X = Size.Y;
-				Size.Y = temp;
-			}
-			UE_LOG(LogVox, Display, TEXT("SIZE: %s"), *Size.ToString());
-		} else if (0 == FCStringAnsi::Strncmp("XYZI", ChunkId, 4)) {
-			uint32 NumVoxels;
-			Ar << NumVoxels;
-			UE_LOG(LogVox, Display, TEXT("XYZI: NumVoxels=%d"), NumVoxels);
-			uint8 X, Y, Z, I;
-			for (uint32 i = 0; i < NumVoxels; ++i) {
-				Ar << X << Y << Z << I;
-				if (ImportOption->bImportXForward) {
-					uint8 temp = X;
-					X = Size.X - Y - 1;
-					Y = Size.Y - temp - 1;
-				} else {
-					X = Size.X - X - 1;
-				}
-				UE_LOG(LogVox, Verbose, TEXT("      Voxel X=%d Y=%d Z=%d I=%d"), X, Y, Z, I);
-				Voxel.Add(FIntVector(X, Y, Z), I);
-			}
-			//store this model into array
-			/*
-			FString chunkIdStr;
-			chunkIdStr.AppendChars(ANSI_TO_TCHAR(ChunkId), 5);
-			models.Add(chunkIdStr,Voxel);
-			*/
-		} else if (0 == FCStringAnsi::Strncmp("RGBA", ChunkId, 4)) {
-			UE_LOG(LogVox, Verbose, TEXT("RGBA:"));
-			FColor Color;
-			for (uint32 i = 0; i < SizeOfChunkContents / 4; ++i) {
-				Ar << Color.R << Color.G << Color.B << Color.A;
-				UE_LOG(LogVox, Verbose, TEXT("      %s"), *Color.ToString());
-				Palette.Add(Color);
-			}
-		} else if (0 == FCStringAnsi::Strncmp("MATT", ChunkId, 4)) {
-			UE_LOG(LogVox, Warning, TEXT("Unsupported MATT chunk."));
-			//btw: * the MATT chunk is deprecated, replaced by the MATL chunk, see (4)
-			uint8 byte;
-			for (uint32 i = 0; i < SizeOfChunkContents; ++i) {
-				Ar << byte;
-			}
-		} else {
-			FString UnknownChunk(ChunkId);
-			UE_LOG(LogVox, Warning, TEXT("Unsupported chunk [ %s ]. Skipping %d byte of chunk contents."), *UnknownChunk, SizeOfChunkContents);
-			uint8 byte;
-			for (uint32 i = 0; i < SizeOfChunkContents; ++i) {
-				Ar << byte;
-			}
-		}
-	} while (!Ar.AtEnd());
+	FVoxCoreAdapter::GetPalette(File, Palette);
 
 	if (Palette.Num() == 0) {
 		for (uint32 i = 0; i < 256; ++i) {
@@ -203,6 +93,7 @@ bool FVox::Import(FArchive& Ar, const UVoxImportOption* ImportOption)
 
 bool FVox::ImportSingleModel(FArchive & Ar, const UVoxImportOption * ImportOption)
 {
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_Parse);
 
 	ANSICHAR ChunkId[5] = { 0, };
 	uint32 SizeOfChunkContents;
@@ -273,6 +164,12 @@ bool FVox::ImportSingleModel(FArchive & Ar, const UVoxImportOption * ImportOptio
 		}
 		else if (0 == FCStringAnsi::Strncmp("SIZE", ChunkId, 4)) {
 			Ar << Size.X << Size.Y << Size.Z;
+			const int32 MaxSize = VoxCore::VoxReader::MaxModelSize;
+			if (Size.X < 1 || Size.Y < 1 || Size.Z < 1 || MaxSize < Size.X || MaxSize < Size.Y || MaxSize < Size.Z) {
+				UE_LOG(LogVox, Error, TEXT("model size out of 1 to %d. %s"), MaxSize, *Size.ToString());
+				Ar.SetError();
+				return false;
+			}
 			if (ImportOption->bImportXForward) {
 				int32 temp = Size.X;
 				Size.X = Size.Y;
@@ -357,17 +254,7 @@ bool FVox::ImportSingleModel(FArchive & Ar, const UVoxImportOption * ImportOptio
  *   | y (back)
  *   |/
  *   +---x (left)
- */
-static const FIntVector Vectors[6] = {
-	FIntVector( 0, 0, 1),	// Up
-	FIntVector( 0, 0,-1),	// Down
-	FIntVector( 1, 0, 0),	// Forward
-	FIntVector(-1, 0, 0),	// Backward
-	FIntVector( 0, 1, 0),	// Right
-	FIntVector( 0,-1, 0)	// Left
-};
-
-/**
+ *
  *   4---5
  *  /|  /|
  * 7---6 |
@@ -433,43 +320,26 @@ static FVector2D TextureCoord[2][3] = {
  */
 bool FVox::CreateRawMesh(FRawMesh& OutRawMesh, const UVoxImportOption* ImportOption) const
 {
-	for (const auto& Cell : Voxel) {
-		FVector Origin(Cell.Key.X, Cell.Key.Y, Cell.Key.Z);
-		for (int FaceIndex = 0; FaceIndex < 6; ++FaceIndex) {
-			const auto n = Cell.Key + Vectors[FaceIndex];
-			if (Voxel.Find(n)) continue;
-
-			TArray<uint32> VertexPositionIndex;
-			for (int VertexIndex = 0; VertexIndex < 4; ++VertexIndex) {
-				FVector v = Origin + Vertexes[Faces[FaceIndex][VertexIndex]];
-				int32 vpi = OutRawMesh.VertexPositions.AddUnique(v);
-				VertexPositionIndex.Add(vpi);
-			}
-
-			uint8 ColorIndex = Cell.Value - 1;
-			for (int PolygonIndex = 0; PolygonIndex < 2; ++PolygonIndex) {
-				OutRawMesh.WedgeIndices.Add(VertexPositionIndex[Polygons[PolygonIndex][0]]);
-				OutRawMesh.WedgeIndices.Add(VertexPositionIndex[Polygons[PolygonIndex][1]]);
-				OutRawMesh.WedgeIndices.Add(VertexPositionIndex[Polygons[PolygonIndex][2]]);
-				OutRawMesh.WedgeColors.Add(Palette[ColorIndex]);
-				OutRawMesh.WedgeColors.Add(Palette[ColorIndex]);
-				OutRawMesh.WedgeColors.Add(Palette[ColorIndex]);
-				OutRawMesh.WedgeTexCoords[0].Add(FVector2D(((double)ColorIndex + 0.5) / 256.0, 0.5));
-				OutRawMesh.WedgeTexCoords[0].Add(FVector2D(((double)ColorIndex + 0.5) / 256.0, 0.5));
-				OutRawMesh.WedgeTexCoords[0].Add(FVector2D(((double)ColorIndex + 0.5) / 256.0, 0.5));
-				OutRawMesh.FaceMaterialIndices.Add(0);
-				OutRawMesh.FaceSmoothingMasks.Add(0);
-			}
-		}
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_Mesh);
+	FVoxelVisibility Visibility;
+	if (ImportOption->bCullEnclosed) {
+		Visibility.Build(Size, Voxel, &Occluder);
 	}
-
-	FVector Offset = ImportOption->bImportXYCenter ? FVector((float)Size.X * 0.5f, (float)Size.Y * 0.5f, 0.f) : FVector::ZeroVector;
-	for (int32 i = 0; i < OutRawMesh.VertexPositions.Num(); ++i) {
-		FVector VertexPosition = OutRawMesh.VertexPositions[i];
-		OutRawMesh.VertexPositions[i] = VertexPosition - Offset;
+	VoxCore::VoxVolume Volume(FVoxCoreAdapter::ToInt3(Size));
+	FVoxCoreAdapter::BuildVolume(*this, ImportOption->bCullEnclosed ? &Visibility : nullptr, Volume);
+	VoxCore::MeshOptions Options;
+	Options.bAmbientOcclusion = ImportOption->bBakeAmbientOcclusion;
+	Options.bGroupByDirection = ImportOption->bGroupByDirection;
+	VoxCore::VoxMesh Mesh;
+	VoxCore::NaiveMesher(Volume, Options).CreateMesh(Mesh);
+	FVoxCoreAdapter::AppendRawMesh(Mesh, GetPivot(ImportOption), OutRawMesh);
+
+	if (!ImportOption->bGroupByDirection) {
+		OutRawMesh.CompactMaterialIndices();
+	}
+	if (ImportOption->bOptimizeVertexCache) {
+		FVertexCacheOptimizer::Optimize(OutRawMesh);
 	}
-
-	OutRawMesh.CompactMaterialIndices();
 	check(OutRawMesh.IsValidOrFixable());
 
 	return true;
@@ -482,13 +352,70 @@ bool FVox::CreateRawMesh(FRawMesh& OutRawMesh, const UVoxImportOption* ImportOpt
  */
 bool FVox::CreateOptimizedRawMesh(FRawMesh& OutRawMesh, const UVoxImportOption* ImportOption) const
 {
-	MonotoneMesh Mesher(this);
-	return Mesher.CreateRawMesh(OutRawMesh, ImportOption);
+	FVoxelVisibility Visibility;
+	if (ImportOption->bCullEnclosed) {
+		Visibility.Build(Size, Voxel, &Occluder);
+	}
+	MonotoneMesh Mesher(this, ImportOption, ImportOption->bCullEnclosed ? &Visibility : nullptr);
+	if (!Mesher.CreateRawMesh(OutRawMesh, ImportOption)) {
+		return false;
+	}
+	if (ImportOption->bOptimizeVertexCache) {
+		FVertexCacheOptimizer::Optimize(OutRawMesh);
+	}
+	return true;
+}
+
+/**
+ * CreateDistanceField
+ * Distance field sampled like engine samples triangles of mesh at distance
+ * field resolution scale of build settings. Sealed cavities are solid.
+ * @param OutData Out distance field in mesh local space
+ * @return false if there is no cell
+ */
+bool FVox::CreateDistanceField(FDistanceFieldVolumeData& OutData, const UVoxImportOption* ImportOption) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_DistanceField);
+	FVoxelVisibility Visibility;
+	Visibility.Build(Size, Voxel, &Occluder);
+	VoxCore::VoxVolume Volume(FVoxCoreAdapter::ToInt3(Size));
+	FVoxCoreAdapter::BuildVolume(*this, &Visibility, Volume);
+
+	static const auto CVarDensity = IConsoleManager::Get().FindTConsoleVariableDataFloat(TEXT("r.DistanceFields.DefaultVoxelDensity"));
+	static const auto CVarMaxResolution = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("r.DistanceFields.MaxPerMeshResolution"));
+	const FMeshBuildSettings& BuildSettings = ImportOption->GetBuildSettings();
+	const float Density = CVarDensity ? CVarDensity->GetValueOnAnyThread() : 0.1f;
+	const int32 MaxResolution = CVarMaxResolution ? CVarMaxResolution->GetValueOnAnyThread() : 128;
+	//engine halves resolution limit unless scale is raised
+	const int32 MaxSamples = BuildSettings.DistanceFieldResolutionScale <= 1.f ? MaxResolution / 2 : MaxResolution;
+	const float SamplesPerCell = Density * BuildSettings.DistanceFieldResolutionScale * BuildSettings.BuildScale3D.GetMax();
+	if (SamplesPerCell <= 0.f) {
+		return false;
+	}
+	VoxCore::DistanceFieldOptions Options;
+	Options.SamplesPerCell = FMath::Max(1, FMath::TruncToInt(SamplesPerCell));
+	Options.CellsPerSample = SamplesPerCell < 1.f ? FMath::CeilToInt(1.f / SamplesPerCell) : 1;
+	for (int32 Axis = 0; Axis < 3; ++Axis) {
+		Options.CellSize[Axis] = BuildSettings.BuildScale3D[Axis];
+	}
+	for (;;) {
+		const VoxCore::Int3 Samples = VoxCore::DistanceField(Volume, Options).GetSize();
+		if (FMath::Max3(Samples.X, Samples.Y, Samples.Z) <= MaxSamples || Size.GetMax() <= Options.CellsPerSample) break;
+		if (1 < Options.SamplesPerCell) --Options.SamplesPerCell;
+		else ++Options.CellsPerSample;
+	}
+
+	VoxCore::VoxDistanceField Field;
+	if (!VoxCore::DistanceField(Volume, Options).Create(Field)) {
+		return false;
+	}
+	FVoxCoreAdapter::ToDistanceFieldVolumeData(Field, GetPivot(ImportOption), BuildSettings.BuildScale3D, OutData);
+	return true;
 }
 
 bool FVox::CreateOptimizedRawMeshes(TArray<FRawMesh>& OutRawMeshes, const UVoxImportOption * ImportOption) const
 {
-	MonotoneMesh Mesher(this);
+	MonotoneMesh Mesher(this, ImportOption);
 	for (int i = 0; i < OutRawMeshes.Num(); i++)
 	{
 		Mesher.CreateRawMesh(OutRawMeshes[i], ImportOption);
@@ -503,6 +430,7 @@ bool FVox::CreateOptimizedRawMeshes(TArray<FRawMesh>& OutRawMeshes, const UVoxIm
  */
 bool FVox::CreateRawMeshes(TArray<FRawMesh>& OutRawMeshes, const UVoxImportOption* ImportOption) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_Mesh);
 	for (const auto& Cell : Voxel) {
 		FRawMesh OutRawMesh;
 
@@ -529,7 +457,7 @@ bool FVox::CreateRawMeshes(TArray<FRawMesh>& OutRawMeshes, const UVoxImportOptio
 		OutRawMeshes.Add(OutRawMesh);
 	}
 
-	FVector Offset = ImportOption->bImportXYCenter ? FVector((float)Size.X * 0.5f, (float)Size.Y * 0.5f, 0.f) : FVector::ZeroVector;
+	const FVector Offset = GetPivot(ImportOption);
 	for (FRawMesh& OutRawMesh : OutRawMeshes) {
 		for (int32 i = 0; i < OutRawMesh.VertexPositions.Num(); ++i) {
 			FVector VertexPosition = OutRawMesh.VertexPositions[i];
@@ -542,9 +470,76 @@ bool FVox::CreateRawMeshes(TArray<FRawMesh>& OutRawMeshes, const UVoxImportOptio
 	return true;
 }
 
+/**
+ * GetAmbientOcclusionColor
+ * @param Level Open sides of vertex, 0 to 3
+ */
+FColor FVox::GetAmbientOcclusionColor(int32 Level)
+{
+	static const uint8 Intensity[4] = { 89, 147, 201, 255 };
+	const uint8 Value = Intensity[FMath::Clamp(Level, 0, 3)];
+	return FColor(Value, Value, Value, 255);
+}
+
+/**
+ * GetPivot
+ * @param ImportOption Import option used to generate mesh
+ * @return Scene position of merged model or XY center if requested
+ */
+FVector FVox::GetPivot(const UVoxImportOption* ImportOption) const
+{
+	if (SceneOffset.IsSet()) {
+		return -SceneOffset.GetValue();
+	}
+	return ImportOption->bImportXYCenter ? FVector((float)Size.X * 0.5f, (float)Size.Y * 0.5f, 0.f) : FVector::ZeroVector;
+}
+
+/**
+ * ComputeHash
+ * @param ImportOption Import option used to generate mesh
+ * @return SHA1 of voxel data, palette and import options as hex string
+ */
+FString FVox::ComputeHash(const UVoxImportOption* ImportOption) const
+{
+	FSHA1 Sha;
+	Sha.Update((const uint8*)&VoxMeshVersion, sizeof(VoxMeshVersion));
+	Sha.Update((const uint8*)&Size, sizeof(FIntVector));
+	for (const auto& Cell : Voxel) {
+		Sha.Update((const uint8*)&Cell.Key, sizeof(FIntVector));
+		Sha.Update(&Cell.Value, sizeof(uint8));
+	}
+	Sha.Update((const uint8*)Palette.GetData(), Palette.Num() * sizeof(FColor));
+	for (const FIntVector& Cell : Occluder) {
+		Sha.Update((const uint8*)&Cell, sizeof(FIntVector));
+	}
+	if (SceneOffset.IsSet()) {
+		Sha.Update((const uint8*)&SceneOffset.GetValue(), sizeof(FVector));
+	}
+	const uint8 Options[] = {
+		(uint8)ImportOption->VoxImportType,
+		(uint8)ImportOption->bImportXForward,
+		(uint8)ImportOption->bImportXYCenter,
+		(uint8)ImportOption->bImportMaterial,
+		(uint8)ImportOption->bComplexCollisionAsSimple,
+		(uint8)ImportOption->bCullEnclosed,
+		(uint8)ImportOption->bBakeAmbientOcclusion,
+		(uint8)ImportOption->bGroupByDirection,
+		(uint8)ImportOption->bOptimizeVertexCache,
+		(uint8)ImportOption->bVoxelDistanceField,
+		(uint8)ImportOption->bVoxelLightmapUVs,
+	};
+	Sha.Update(Options, sizeof(Options));
+	Sha.Update((const uint8*)&ImportOption->Scale, sizeof(float));
+	Sha.Final();
+
+	FSHAHash Hash;
+	Sha.GetHash(Hash.Hash);
+	return Hash.ToString();
+}
 
 bool FVox::CreateTexture(UTexture2D* const& OutTexture, UVoxImportOption* ImportOption) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_Material);
 	check(OutTexture);
 	OutTexture->LODGroup = TextureGroup::TEXTUREGROUP_World;
 	OutTexture->CompressionSettings = TextureCompressionSettings::TC_Default;
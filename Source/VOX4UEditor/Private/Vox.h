@@ -3,8 +3,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include <Misc/Optional.h>
 #include <RawMesh.h>
 
+class FDistanceFieldVolumeData;
 class UTexture2D;
 class UVoxImportOption;
 
@@ -37,6 +39,11 @@ struct FVox
 	//scene model name
 	FString modelName;
 
+	/** Cells of adjacent models in merged scene, faces toward them are culled */
+	TSet<FIntVector> Occluder;
+	/** Position of model in merged scene, used instead of XY centering */
+	TOptional<FVector> SceneOffset;
+
 public:
 
 	/** Create empty vox data */
@@ -60,12 +67,24 @@ public:
 	/** Create FRawMeshes from Voxel models array, use Monotone mesh generation */
 	bool CreateOptimizedRawMeshes(TArray<FRawMesh>& OutRawMeshes, const UVoxImportOption* ImportOption) const;
 
+	/** Create signed distance field of mesh from Voxel */
+	bool CreateDistanceField(FDistanceFieldVolumeData& OutData, const UVoxImportOption* ImportOption) const;
+
 	/** Create raw meshes from Voxel */
 	bool CreateRawMeshes(TArray<FRawMesh>& OutRawMeshes, const UVoxImportOption* ImportOption) const;
 
+	/** Offset subtracted from generated vertex positions */
+	FVector GetPivot(const UVoxImportOption* ImportOption) const;
+
+	/** Hash of voxel data, palette and mesh relevant import options */
+	FString ComputeHash(const UVoxImportOption* ImportOption) const;
+
 	/** Create UTexture2D from Palette */
 	bool CreateTexture(UTexture2D* const& OutTexture, UVoxImportOption* ImportOption) const;
 
+	/** Vertex color of ambient occlusion level, 0 for fully occluded to 3 for open corner */
+	static FColor GetAmbientOcclusionColor(int32 Level);
+
 	/** Create one raw mesh */
 	static bool CreateMesh(FRawMesh& OutRawMesh, const UVoxImportOption* ImportOption);
 
@@ -8,6 +8,14 @@ UVoxAssetImportData::UVoxAssetImportData()
 	, bImportXYCenter(true)
 	, Scale(10.f)
 	, bImportMaterial(true)
+	, bCullEnclosed(false)
+	, bBakeAmbientOcclusion(false)
+	, bGroupByDirection(false)
+	, bOptimizeVertexCache(true)
+	, bVoxelDistanceField(true)
+	, bVoxelLightmapUVs(true)
+	, bImportScene(false)
+	, bMergeScene(false)
 {
 }
 
@@ -20,6 +28,14 @@ void UVoxAssetImportData::ToVoxImportOption(UVoxImportOption& OutVoxImportOption
 	OutVoxImportOption.BuildSettings.BuildScale3D = FVector(Scale);
 	OutVoxImportOption.bImportMaterial = bImportMaterial;
 	OutVoxImportOption.bComplexCollisionAsSimple = bComplexCollisionAsSimple;
+	OutVoxImportOption.bCullEnclosed = bCullEnclosed;
+	OutVoxImportOption.bBakeAmbientOcclusion = bBakeAmbientOcclusion;
+	OutVoxImportOption.bGroupByDirection = bGroupByDirection;
+	OutVoxImportOption.bOptimizeVertexCache = bOptimizeVertexCache;
+	OutVoxImportOption.bVoxelDistanceField = bVoxelDistanceField;
+	OutVoxImportOption.bVoxelLightmapUVs = bVoxelLightmapUVs;
+	OutVoxImportOption.bImportScene = bImportScene;
+	OutVoxImportOption.bMergeScene = bMergeScene;
 }
 
 void UVoxAssetImportData::FromVoxImportOption(const UVoxImportOption& VoxImportOption)
@@ -30,4 +46,12 @@ void UVoxAssetImportData::FromVoxImportOption(const UVoxImportOption& VoxImportO
 	Scale = VoxImportOption.Scale;
 	bImportMaterial = VoxImportOption.bImportMaterial;
 	bComplexCollisionAsSimple = VoxImportOption.bComplexCollisionAsSimple;
+	bCullEnclosed = VoxImportOption.bCullEnclosed;
+	bBakeAmbientOcclusion = VoxImportOption.bBakeAmbientOcclusion;
+	bGroupByDirection = VoxImportOption.bGroupByDirection;
+	bOptimizeVertexCache = VoxImportOption.bOptimizeVertexCache;
+	bVoxelDistanceField = VoxImportOption.bVoxelDistanceField;
+	bVoxelLightmapUVs = VoxImportOption.bVoxelLightmapUVs;
+	bImportScene = VoxImportOption.bImportScene;
+	bMergeScene = VoxImportOption.bMergeScene;
 }
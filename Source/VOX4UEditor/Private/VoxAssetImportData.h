@@ -34,6 +34,34 @@ public:
 	UPROPERTY(EditAnywhere, Category = Generic)
 	bool bComplexCollisionAsSimple;
 
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bCullEnclosed;
+
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bBakeAmbientOcclusion;
+
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bGroupByDirection;
+
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bOptimizeVertexCache;
+
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bVoxelDistanceField;
+
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bVoxelLightmapUVs;
+
+	UPROPERTY(EditAnywhere, Category = Scene)
+	bool bImportScene;
+
+	UPROPERTY(EditAnywhere, Category = Scene)
+	bool bMergeScene;
+
+	/** Hash of voxel data, palette and import options the asset was built from */
+	UPROPERTY(VisibleAnywhere, Category = Reimport)
+	FString SourceHash;
+
 public:
 
 	UVoxAssetImportData();
@@ -0,0 +1,217 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxCoreAdapter.h"
+#include <DistanceFieldAtlas.h>
+#include <HAL/IConsoleManager.h>
+#include <Misc/Compression.h>
+#include <RawMesh.h>
+#include <Serialization/BufferReader.h>
+#include "Vox.h"
+#include "VoxImportOption.h"
+#include "VoxImportStats.h"
+#include "VoxelVisibility.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVoxCore, Log, All)
+
+bool FVoxCoreAdapter::ReadVox(FArchive& Ar, VoxCore::VoxFile& OutFile, TFunctionRef<void(const VoxCore::VoxChunk&, FArchive&)> OnChunk)
+{
+	TArray<uint8> Data;
+	Data.SetNumUninitialized(Ar.TotalSize() - Ar.Tell());
+	Ar.Serialize(Data.GetData(), Data.Num());
+	if (Ar.IsError()) {
+		UE_LOG(LogVoxCore, Error, TEXT("can not read vox data"));
+		return false;
+	}
+
+	const VoxCore::VoxError Error = VoxCore::VoxReader(Data.GetData(), Data.Num()).Read(OutFile, [&](const VoxCore::VoxChunk& Chunk) {
+		FBufferReader ChunkAr((void*)Chunk.Data, Chunk.Size, false);
+		OnChunk(Chunk, ChunkAr);
+	});
+	switch (Error) {
+	case VoxCore::VoxError::NotVox:
+		UE_LOG(LogVoxCore, Error, TEXT("not a vox format"));
+		return false;
+	case VoxCore::VoxError::UnsupportedVersion:
+		UE_LOG(LogVoxCore, Error, TEXT("unsupported version. %d"), OutFile.Version);
+		return false;
+	case VoxCore::VoxError::Truncated:
+		UE_LOG(LogVoxCore, Error, TEXT("truncated vox data"));
+		return false;
+	case VoxCore::VoxError::InvalidSize:
+		UE_LOG(LogVoxCore, Error, TEXT("model size out of 1 to %d"), VoxCore::VoxReader::MaxModelSize);
+		return false;
+	default:
+		break;
+	}
+	//cells in z order keep neighbours close for every later pass
+	VoxCore::Morton::Sort(OutFile);
+	UE_LOG(LogVoxCore, Verbose, TEXT("VERSION NUMBER: %d, %d models"), OutFile.Version, (int32)OutFile.Models.size());
+	return true;
+}
+
+bool FVoxCoreAdapter::ReadVox(FArchive& Ar, VoxCore::VoxFile& OutFile)
+{
+	return ReadVox(Ar, OutFile, [](const VoxCore::VoxChunk& Chunk, FArchive& ChunkAr) {
+		ANSICHAR ChunkId[5] = { 0, };
+		FMemory::Memcpy(ChunkId, Chunk.Id, 4);
+		UE_LOG(LogVoxCore, Verbose, TEXT("Unsupported chunk [ %s ]. Skipping %d byte of chunk contents."), ANSI_TO_TCHAR(ChunkId), Chunk.Size);
+	});
+}
+
+FIntVector FVoxCoreAdapter::GetSize(const VoxCore::VoxModel& Model, const UVoxImportOption* ImportOption)
+{
+	return ImportOption->bImportXForward
+		? FIntVector(Model.Size.Y, Model.Size.X, Model.Size.Z)
+		: FIntVector(Model.Size.X, Model.Size.Y, Model.Size.Z);
+}
+
+void FVoxCoreAdapter::GetCells(const VoxCore::VoxModel& Model, const UVoxImportOption* ImportOption, TMap<FIntVector, uint8>& OutCells)
+{
+	const FIntVector Size = GetSize(Model, ImportOption);
+	OutCells.Reserve(OutCells.Num() + Model.Cells.size());
+	for (const VoxCore::VoxCell& Cell : Model.Cells) {
+		if (ImportOption->bImportXForward) {
+			OutCells.Add(FIntVector(Size.X - Cell.Y - 1, Size.Y - Cell.X - 1, Cell.Z), Cell.I);
+		} else {
+			OutCells.Add(FIntVector(Size.X - Cell.X - 1, Cell.Y, Cell.Z), Cell.I);
+		}
+	}
+}
+
+void FVoxCoreAdapter::GetPalette(const VoxCore::VoxFile& File, TArray<FColor>& OutPalette)
+{
+	OutPalette.Reserve(OutPalette.Num() + File.Palette.size());
+	for (const VoxCore::Color& Color : File.Palette) {
+		OutPalette.Add(FColor(Color.R, Color.G, Color.B, Color.A));
+	}
+}
+
+void FVoxCoreAdapter::BuildVolume(const FVox& Vox, const FVoxelVisibility* Visibility, VoxCore::VoxVolume& OutVolume)
+{
+	for (const auto& Cell : Vox.Voxel) {
+		OutVolume.Set(ToInt3(Cell.Key), Cell.Value);
+	}
+	for (const FIntVector& Cell : Vox.Occluder) {
+		OutVolume.SetOccluded(ToInt3(Cell), true);
+	}
+	if (Visibility) {
+		FIntVector Cell;
+		for (Cell.Z = -1; Cell.Z <= Vox.Size.Z; ++Cell.Z) {
+			for (Cell.Y = -1; Cell.Y <= Vox.Size.Y; ++Cell.Y) {
+				for (Cell.X = -1; Cell.X <= Vox.Size.X; ++Cell.X) {
+					if (!Visibility->IsExterior(Cell)) {
+						OutVolume.SetOccluded(ToInt3(Cell), true);
+					}
+				}
+			}
+		}
+	}
+}
+
+void FVoxCoreAdapter::AppendRawMesh(const VoxCore::VoxMesh& Mesh, const FVector& Pivot, FRawMesh& OutRawMesh)
+{
+	const uint32 BaseIndex = OutRawMesh.VertexPositions.Num();
+	OutRawMesh.VertexPositions.Reserve(BaseIndex + Mesh.Positions.size());
+	for (const VoxCore::Int3& Position : Mesh.Positions) {
+		OutRawMesh.VertexPositions.Add(FVector(Position.X, Position.Y, Position.Z) - Pivot);
+	}
+	const bool bColors = !Mesh.WedgeAO.empty();
+	//every wedge of raw mesh needs lightmap UV or none
+	std::vector<float> LightmapUVs;
+	if (!Mesh.Charts.empty() && OutRawMesh.WedgeTexCoords[1].Num() == OutRawMesh.WedgeIndices.Num()) {
+		SCOPE_CYCLE_COUNTER(STAT_VoxImport_LightmapUVs);
+		const VoxCore::LightmapPacker Packer;
+		VoxCore::LightmapLayout Layout;
+		if (Packer.Pack(Mesh, Layout)) {
+			Packer.GetWedgeUVs(Mesh, Layout, LightmapUVs);
+		}
+	}
+	for (size_t Wedge = 0; Wedge < Mesh.Indices.size(); ++Wedge) {
+		const uint8 ColorIndex = Mesh.Colors[Wedge / 3];
+		OutRawMesh.WedgeIndices.Add(BaseIndex + Mesh.Indices[Wedge]);
+		if (bColors) {
+			OutRawMesh.WedgeColors.Add(FVox::GetAmbientOcclusionColor(Mesh.WedgeAO[Wedge]));
+		}
+		OutRawMesh.WedgeTexCoords[0].Add(FVector2D(((double)ColorIndex + 0.5) / 256.0, 0.5));
+		if (!LightmapUVs.empty()) {
+			OutRawMesh.WedgeTexCoords[1].Add(FVector2D(LightmapUVs[Wedge * 2], LightmapUVs[Wedge * 2 + 1]));
+		}
+	}
+	for (size_t Triangle = 0; Triangle < Mesh.GetNumTriangles(); ++Triangle) {
+		OutRawMesh.FaceMaterialIndices.Add(Mesh.Materials[Triangle]);
+		OutRawMesh.FaceSmoothingMasks.Add(0);
+	}
+}
+
+int32 FVoxCoreAdapter::GetLightmapResolution(const FRawMesh& RawMesh)
+{
+	const TArray<FVector2D>& UVs = RawMesh.WedgeTexCoords[1];
+	if (UVs.Num() == 0 || UVs.Num() != RawMesh.WedgeIndices.Num()) {
+		return 0;
+	}
+	//cell edge spans one texel unless charts were shrunk at greatest resolution,
+	//longest edge of first triangle keeps rounding error of UVs small
+	const int32 MaxResolution = VoxCore::LightmapOptions().MaxResolution;
+	float Length = 0.f, UVLength = 0.f;
+	for (int32 Wedge = 0; Wedge < 3; ++Wedge) {
+		const int32 Next = (Wedge + 1) % 3;
+		const float EdgeLength = (RawMesh.VertexPositions[RawMesh.WedgeIndices[Next]] - RawMesh.VertexPositions[RawMesh.WedgeIndices[Wedge]]).Size();
+		if (Length < EdgeLength) {
+			Length = EdgeLength;
+			UVLength = (UVs[Next] - UVs[Wedge]).Size();
+		}
+	}
+	if (UVLength <= 0.f) {
+		return MaxResolution;
+	}
+	const int32 Resolution = FMath::RoundToInt(Length / UVLength);
+	return FMath::Min(Resolution, MaxResolution);
+}
+
+void FVoxCoreAdapter::ToDistanceFieldVolumeData(const VoxCore::VoxDistanceField& Field, const FVector& Pivot, const FVector& Scale, FDistanceFieldVolumeData& OutData)
+{
+	const FVector Min = (FVector(Field.Min[0], Field.Min[1], Field.Min[2]) - Pivot) * Scale;
+	const FVector Extent(Field.Size.X * Field.SampleSize[0], Field.Size.Y * Field.SampleSize[1], Field.Size.Z * Field.SampleSize[2]);
+	OutData.Size = FIntVector(Field.Size.X, Field.Size.Y, Field.Size.Z);
+	OutData.LocalBoundingBox = FBox(Min, Min + Extent);
+
+	//same volume space, range and format as fields engine builds from triangles
+	const float LocalToVolume = 1.f / OutData.LocalBoundingBox.GetExtent().GetMax();
+	float MinDistance = 1.f, MaxDistance = -1.f;
+	for (float Distance : Field.Distances) {
+		MinDistance = FMath::Min(MinDistance, Distance * LocalToVolume);
+		MaxDistance = FMath::Max(MaxDistance, Distance * LocalToVolume);
+	}
+	MinDistance = FMath::Max(MinDistance, -1.f);
+	MaxDistance = FMath::Min(MaxDistance, 1.f);
+
+	static const auto CVarEightBit = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("r.DistanceFieldBuild.EightBit"));
+	static const auto CVarCompress = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("r.DistanceFieldBuild.Compress"));
+	TArray<uint8> Volume;
+	if (CVarEightBit && CVarEightBit->GetValueOnAnyThread() != 0) {
+		const float InvRange = 1.f / (MaxDistance - MinDistance);
+		Volume.SetNumUninitialized(Field.Distances.size());
+		for (int32 i = 0; i < Volume.Num(); ++i) {
+			const float Rescaled = (Field.Distances[i] * LocalToVolume - MinDistance) * InvRange;
+			Volume[i] = (uint8)FMath::Clamp(FMath::FloorToInt(Rescaled * 255.f + .5f), 0, 255);
+		}
+	} else {
+		Volume.SetNumUninitialized(Field.Distances.size() * sizeof(FFloat16));
+		FFloat16* Values = (FFloat16*)Volume.GetData();
+		for (size_t i = 0; i < Field.Distances.size(); ++i) {
+			Values[i] = FFloat16(Field.Distances[i] * LocalToVolume);
+		}
+	}
+	if (CVarCompress && CVarCompress->GetValueOnAnyThread() != 0) {
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Volume.Num());
+		OutData.CompressedDistanceFieldVolume.SetNumUninitialized(CompressedSize);
+		verify(FCompression::CompressMemory(NAME_Zlib, OutData.CompressedDistanceFieldVolume.GetData(), CompressedSize, Volume.GetData(), Volume.Num()));
+		OutData.CompressedDistanceFieldVolume.SetNum(CompressedSize, false);
+	} else {
+		OutData.CompressedDistanceFieldVolume = MoveTemp(Volume);
+	}
+	OutData.DistanceMinMax = FVector2D(MinDistance, MaxDistance);
+	OutData.bMeshWasClosed = true;
+	OutData.bBuiltAsIfTwoSided = false;
+	OutData.bMeshWasPlane = false;
+}
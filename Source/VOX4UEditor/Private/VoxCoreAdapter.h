@@ -0,0 +1,57 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Templates/Function.h>
+#include "VoxCore/VoxCore.h"
+
+class FDistanceFieldVolumeData;
+struct FRawMesh;
+struct FVox;
+struct FVoxelVisibility;
+class UVoxImportOption;
+
+/**
+ * @struct FVoxCoreAdapter
+ * Conversion between VoxCore and unreal types.
+ */
+struct FVoxCoreAdapter
+{
+	/** Read rest of archive as vox data with cells of every model in Z order, chunks not read by VoxCore are passed to OnChunk with archive of contents */
+	static bool ReadVox(FArchive& Ar, VoxCore::VoxFile& OutFile, TFunctionRef<void(const VoxCore::VoxChunk&, FArchive&)> OnChunk);
+
+	/** Read rest of archive as vox data */
+	static bool ReadVox(FArchive& Ar, VoxCore::VoxFile& OutFile);
+
+	/** Size of model in unreal axes */
+	static FIntVector GetSize(const VoxCore::VoxModel& Model, const UVoxImportOption* ImportOption);
+
+	/** Add cells of model in unreal axes */
+	static void GetCells(const VoxCore::VoxModel& Model, const UVoxImportOption* ImportOption, TMap<FIntVector, uint8>& OutCells);
+
+	/** Add palette of file, nothing for default palette */
+	static void GetPalette(const VoxCore::VoxFile& File, TArray<FColor>& OutPalette);
+
+	/** Fill dense volume of vox, occluder cells and cells out of exterior space are occluded */
+	static void BuildVolume(const FVox& Vox, const FVoxelVisibility* Visibility, VoxCore::VoxVolume& OutVolume);
+
+	/** Append mesh to raw mesh with positions relative to pivot, charts of mesh are packed into UV channel 1 */
+	static void AppendRawMesh(const VoxCore::VoxMesh& Mesh, const FVector& Pivot, FRawMesh& OutRawMesh);
+
+	/** Lightmap resolution charts of raw mesh were packed for, 0 if no triangle has lightmap UVs */
+	static int32 GetLightmapResolution(const FRawMesh& RawMesh);
+
+	/** Quantize distance field to engine volume data in mesh local space, cell corner at position times scale less pivot */
+	static void ToDistanceFieldVolumeData(const VoxCore::VoxDistanceField& Field, const FVector& Pivot, const FVector& Scale, FDistanceFieldVolumeData& OutData);
+
+	static VoxCore::Int3 ToInt3(const FIntVector& Vector)
+	{
+		return VoxCore::Int3(Vector.X, Vector.Y, Vector.Z);
+	}
+
+	static FIntVector ToIntVector(const VoxCore::Int3& Vector)
+	{
+		return FIntVector(Vector.X, Vector.Y, Vector.Z);
+	}
+};
@@ -12,6 +12,14 @@ UVoxImportOption::UVoxImportOption()
 	, bImportXYCenter(true)
 	, Scale(10.f)
 	, bImportMaterial(true)
+	, bCullEnclosed(false)
+	, bBakeAmbientOcclusion(false)
+	, bGroupByDirection(false)
+	, bOptimizeVertexCache(true)
+	, bVoxelDistanceField(true)
+	, bVoxelLightmapUVs(true)
+	, bImportScene(false)
+	, bMergeScene(false)
 {
 	BuildSettings.BuildScale3D = FVector(Scale);
 }
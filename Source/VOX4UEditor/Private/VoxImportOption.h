@@ -15,6 +15,7 @@ enum class EVoxImportType
 	SkeletalMesh UMETA(DisplayName = "Skeletal Mesh"),
 	DestructibleMesh UMETA(DisplayName = "Destructible Mesh"),
 	Voxel UMETA(DisplayName = "Voxel"),
+	Animation UMETA(DisplayName = "Animation"),
 };
 
 /**
@@ -45,6 +46,38 @@ public:
 	UPROPERTY(EditAnywhere, Category = Generic)
 	bool bComplexCollisionAsSimple;
 
+	/** Treat sealed cavities unreachable from outside as solid and skip their inner walls */
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bCullEnclosed;
+
+	/** Bake voxel corner occlusion into vertex colors, multiplied into base color by material */
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bBakeAmbientOcclusion;
+
+	/** Sort faces into six sections by direction for Voxel Mesh Component to cull back facing sides */
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bGroupByDirection;
+
+	/** Reorder triangles for vertex cache and vertices for fetch locality */
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bOptimizeVertexCache;
+
+	/** Compute mesh distance field from cells by exact distance transform instead of tracing triangles */
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bVoxelDistanceField;
+
+	/** Chart every merged polygon at voxel resolution into lightmap UVs instead of engine unwrapping */
+	UPROPERTY(EditAnywhere, Category = Generic)
+	bool bVoxelLightmapUVs;
+
+	/** Generate blueprint placing every model instance of the vox scene with instanced static mesh components */
+	UPROPERTY(EditAnywhere, Category = Scene)
+	bool bImportScene;
+
+	/** Place models in scene space and cull faces hidden by adjacent models, one mesh per placement */
+	UPROPERTY(EditAnywhere, Category = Scene)
+	bool bMergeScene;
+
 public:
 
 	UVoxImportOption();
@@ -0,0 +1,78 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxImportStats.h"
+#include <Engine/StaticMesh.h>
+#include <HAL/PlatformMemory.h>
+#include <HAL/PlatformTime.h>
+#include <RawMesh.h>
+#include <StaticMeshResources.h>
+#include "VertexCacheOptimizer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVoxImport, Log, All)
+
+DEFINE_STAT(STAT_VoxImport_Parse);
+DEFINE_STAT(STAT_VoxImport_Mesh);
+DEFINE_STAT(STAT_VoxImport_VertexCache);
+DEFINE_STAT(STAT_VoxImport_LightmapUVs);
+DEFINE_STAT(STAT_VoxImport_DistanceField);
+DEFINE_STAT(STAT_VoxImport_BuildStaticMesh);
+DEFINE_STAT(STAT_VoxImport_Material);
+
+FVoxImportStatistics::FVoxImportStatistics()
+{
+	Reset();
+}
+
+void FVoxImportStatistics::Reset()
+{
+	StartTime = FPlatformTime::Seconds();
+	StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	PeakUsedPhysical = StartUsedPhysical;
+	NumModels = 0;
+	NumVoxels = 0;
+	NumVertices = 0;
+	NumTriangles = 0;
+	NumBuiltTriangles = 0;
+	NumCacheMisses = 0;
+}
+
+void FVoxImportStatistics::AddModel(int32 InNumVoxels)
+{
+	++NumModels;
+	NumVoxels += InNumVoxels;
+}
+
+void FVoxImportStatistics::AddRawMesh(const FRawMesh& RawMesh)
+{
+	NumVertices += RawMesh.VertexPositions.Num();
+	NumTriangles += RawMesh.WedgeIndices.Num() / 3;
+	SampleMemory();
+}
+
+void FVoxImportStatistics::AddStaticMesh(const UStaticMesh* StaticMesh)
+{
+	if (!StaticMesh->RenderData || StaticMesh->RenderData->LODResources.Num() == 0) return;
+	TArray<uint32> Indices;
+	StaticMesh->RenderData->LODResources[0].IndexBuffer.GetCopy(Indices);
+	NumBuiltTriangles += Indices.Num() / 3;
+	NumCacheMisses += FVertexCacheOptimizer::CountCacheMisses(Indices);
+}
+
+void FVoxImportStatistics::SampleMemory()
+{
+	check(IsInGameThread());
+	PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+}
+
+void FVoxImportStatistics::Log(const FString& Filename)
+{
+	SampleMemory();
+	const double WallTime = FPlatformTime::Seconds() - StartTime;
+	//peak of samples after every stage over start, and peak of process from platform
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	const double PeakDelta = (double)(PeakUsedPhysical - StartUsedPhysical) / (1024.0 * 1024.0);
+	const double ProcessPeak = (double)MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0);
+	const double ACMR = 0 < NumBuiltTriangles ? (double)NumCacheMisses / NumBuiltTriangles : 0.0;
+	UE_LOG(LogVoxImport, Display, TEXT("%s: %.3f sec, %d models, %lld voxels, %lld vertices, %lld triangles, ACMR %.3f, peak memory +%.2f MB (process peak %.2f MB)"),
+		*FPaths::GetCleanFilename(Filename), WallTime, NumModels, NumVoxels, NumVertices, NumTriangles, ACMR, PeakDelta, ProcessPeak);
+}
@@ -0,0 +1,69 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Stats/Stats.h>
+
+struct FRawMesh;
+class UStaticMesh;
+
+DECLARE_STATS_GROUP(TEXT("VOX4U Import"), STATGROUP_VoxImport, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Parse"), STAT_VoxImport_Parse, STATGROUP_VoxImport, );
+/** Meshing in VoxCore, vertex weld included */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mesh"), STAT_VoxImport_Mesh, STATGROUP_VoxImport, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Vertex cache"), STAT_VoxImport_VertexCache, STATGROUP_VoxImport, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Lightmap UVs"), STAT_VoxImport_LightmapUVs, STATGROUP_VoxImport, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Distance field"), STAT_VoxImport_DistanceField, STATGROUP_VoxImport, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build static mesh"), STAT_VoxImport_BuildStaticMesh, STATGROUP_VoxImport, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Material and texture"), STAT_VoxImport_Material, STATGROUP_VoxImport, );
+
+/**
+ * @struct FVoxImportStatistics
+ * Per import summary of wall time, generated geometry and memory usage.
+ */
+struct FVoxImportStatistics
+{
+	/** Wall clock at start of import */
+	double StartTime;
+	/** Used physical memory at start of import */
+	uint64 StartUsedPhysical;
+	/** Highest used physical memory of process sampled after every stage of import */
+	uint64 PeakUsedPhysical;
+
+	/** Imported models */
+	int32 NumModels;
+	/** Imported voxels */
+	int64 NumVoxels;
+	/** Generated vertices */
+	int64 NumVertices;
+	/** Generated triangles */
+	int64 NumTriangles;
+	/** Triangles of built static mesh index buffers */
+	int64 NumBuiltTriangles;
+	/** Vertex transforms of built index buffers through simulated FIFO cache */
+	int64 NumCacheMisses;
+
+public:
+
+	FVoxImportStatistics();
+
+	/** Start new import */
+	void Reset();
+
+	/** Count model and voxels */
+	void AddModel(int32 InNumVoxels);
+
+	/** Count generated geometry */
+	void AddRawMesh(const FRawMesh& RawMesh);
+
+	/** Count cache misses of LOD 0 index buffer as engine built and renders it */
+	void AddStaticMesh(const UStaticMesh* StaticMesh);
+
+	/** Sample current memory usage, on game thread after every stage */
+	void SampleMemory();
+
+	/** Write summary to log */
+	void Log(const FString& Filename);
+};
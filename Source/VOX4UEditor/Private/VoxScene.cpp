@@ -0,0 +1,330 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#include "VoxScene.h"
+#include "Vox.h"
+#include "VoxImportOption.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVoxScene, Log, All)
+
+/** Guard against cyclic scene graph of broken files */
+static const int32 MaxSceneDepth = 256;
+
+FVoxRotation::FVoxRotation()
+{
+	Rows[0] = FIntVector(1, 0, 0);
+	Rows[1] = FIntVector(0, 1, 0);
+	Rows[2] = FIntVector(0, 0, 1);
+}
+
+/**
+ * FromPacked
+ * bit | value
+ * 0-1 : index of the non-zero entry in the first row
+ * 2-3 : index of the non-zero entry in the second row
+ * 4   : the sign in the first row (0 : positive; 1 : negative)
+ * 5   : the sign in the second row
+ * 6   : the sign in the third row
+ */
+FVoxRotation FVoxRotation::FromPacked(uint8 Packed)
+{
+	const int32 Index0 = Packed & 3;
+	const int32 Index1 = (Packed >> 2) & 3;
+	const int32 Index2 = 3 - Index0 - Index1;
+	FVoxRotation Rotation;
+	if (Index0 == Index1 || Index2 < 0 || 2 < Index2) {
+		UE_LOG(LogVoxScene, Warning, TEXT("Invalid rotation %d."), Packed);
+		return Rotation;
+	}
+	Rotation.Rows[0] = FIntVector::ZeroValue;
+	Rotation.Rows[1] = FIntVector::ZeroValue;
+	Rotation.Rows[2] = FIntVector::ZeroValue;
+	Rotation.Rows[0][Index0] = Packed & (1 << 4) ? -1 : 1;
+	Rotation.Rows[1][Index1] = Packed & (1 << 5) ? -1 : 1;
+	Rotation.Rows[2][Index2] = Packed & (1 << 6) ? -1 : 1;
+	return Rotation;
+}
+
+FIntVector FVoxRotation::operator*(const FIntVector& Vector) const
+{
+	FIntVector Result;
+	for (int32 i = 0; i < 3; ++i) {
+		Result[i] = Rows[i].X * Vector.X + Rows[i].Y * Vector.Y + Rows[i].Z * Vector.Z;
+	}
+	return Result;
+}
+
+FVoxRotation FVoxRotation::operator*(const FVoxRotation& Other) const
+{
+	FVoxRotation Result;
+	for (int32 i = 0; i < 3; ++i) {
+		for (int32 j = 0; j < 3; ++j) {
+			Result.Rows[i][j] = Rows[i].X * Other.Rows[0][j] + Rows[i].Y * Other.Rows[1][j] + Rows[i].Z * Other.Rows[2][j];
+		}
+	}
+	return Result;
+}
+
+FVoxTransform FVoxTransform::operator*(const FVoxTransform& Child) const
+{
+	FVoxTransform Result;
+	Result.Rotation = Rotation * Child.Rotation;
+	Result.Translation = Translation + Rotation * Child.Translation;
+	return Result;
+}
+
+/**
+ * ReadTransformNode
+ * int32	: node id
+ * DICT		: node attributes (_name : string) (_hidden : 0/1)
+ * int32	: child node id
+ * int32	: reserved id (must be -1)
+ * int32	: layer id
+ * int32	: num of frames (must be 1)
+ * DICT		: frame attributes (_r : int8) (_t : int32x3) x N
+ */
+int32 FVoxScene::ReadTransformNode(FArchive& Ar)
+{
+	int32 NodeId, ChildId, ReservedId, LayerId, NumFrames;
+	Ar << NodeId;
+	FVoxSceneNode Node;
+	Node.Type = EVoxSceneNodeType::Transform;
+	const TMap<FString, FString> Attributes = FVox::ReadVoxDictionary(Ar);
+	if (const FString* Name = Attributes.Find(TEXT("_name"))) {
+		Node.Name = *Name;
+	}
+	if (const FString* Hidden = Attributes.Find(TEXT("_hidden"))) {
+		Node.bHidden = *Hidden == TEXT("1");
+	}
+	Ar << ChildId << ReservedId << LayerId << NumFrames;
+	Node.Children.Add(ChildId);
+	for (int32 i = 0; i < NumFrames && !Ar.IsError(); ++i) {
+		const TMap<FString, FString> Frame = FVox::ReadVoxDictionary(Ar);
+		if (i != 0) continue;
+		if (const FString* Rotation = Frame.Find(TEXT("_r"))) {
+			Node.Transform.Rotation = FVoxRotation::FromPacked((uint8)FCString::Atoi(**Rotation));
+		}
+		if (const FString* Translation = Frame.Find(TEXT("_t"))) {
+			TArray<FString> Values;
+			Translation->ParseIntoArrayWS(Values);
+			for (int32 j = 0; j < 3 && j < Values.Num(); ++j) {
+				Node.Transform.Translation[j] = FCString::Atoi(*Values[j]);
+			}
+		}
+	}
+	Nodes.Add(NodeId, Node);
+	return NodeId;
+}
+
+/**
+ * ReadGroupNode
+ * int32	: node id
+ * DICT		: node attributes
+ * int32	: num of children nodes
+ * int32	: child node id x N
+ */
+int32 FVoxScene::ReadGroupNode(FArchive& Ar)
+{
+	int32 NodeId, NumChildren;
+	Ar << NodeId;
+	FVoxSceneNode Node;
+	Node.Type = EVoxSceneNodeType::Group;
+	FVox::ReadVoxDictionary(Ar);
+	Ar << NumChildren;
+	for (int32 i = 0; i < NumChildren && !Ar.IsError(); ++i) {
+		int32 ChildId;
+		Ar << ChildId;
+		Node.Children.Add(ChildId);
+	}
+	Nodes.Add(NodeId, Node);
+	return NodeId;
+}
+
+/**
+ * ReadShapeNode
+ * int32	: node id
+ * DICT		: node attributes
+ * int32	: num of models (must be 1)
+ * int32	: model id, DICT : model attributes x N
+ */
+int32 FVoxScene::ReadShapeNode(FArchive& Ar)
+{
+	int32 NodeId, NumModels;
+	Ar << NodeId;
+	FVoxSceneNode Node;
+	Node.Type = EVoxSceneNodeType::Shape;
+	FVox::ReadVoxDictionary(Ar);
+	Ar << NumModels;
+	for (int32 i = 0; i < NumModels && !Ar.IsError(); ++i) {
+		int32 ModelId;
+		Ar << ModelId;
+		FVox::ReadVoxDictionary(Ar);
+		Node.Models.Add(ModelId);
+	}
+	Nodes.Add(NodeId, Node);
+	return NodeId;
+}
+
+void FVoxScene::GetInstances(TArray<FVoxModelInstance>& OutInstances) const
+{
+	if (Nodes.Contains(0)) {
+		GetInstances(OutInstances, 0, FVoxTransform(), FString(), 0);
+	}
+}
+
+void FVoxScene::GetInstances(TArray<FVoxModelInstance>& OutInstances, int32 NodeId, const FVoxTransform& Parent, const FString& Name, int32 Depth) const
+{
+	const FVoxSceneNode* Node = Nodes.Find(NodeId);
+	if (!Node || MaxSceneDepth < Depth) {
+		UE_LOG(LogVoxScene, Warning, TEXT("Invalid scene node %d."), NodeId);
+		return;
+	}
+	switch (Node->Type) {
+	case EVoxSceneNodeType::Transform:
+		if (!Node->bHidden) {
+			const FVoxTransform Transform = Parent * Node->Transform;
+			const FString& NodeName = Node->Name.IsEmpty() ? Name : Node->Name;
+			for (int32 ChildId : Node->Children) {
+				GetInstances(OutInstances, ChildId, Transform, NodeName, Depth + 1);
+			}
+		}
+		break;
+	case EVoxSceneNodeType::Group:
+		for (int32 ChildId : Node->Children) {
+			GetInstances(OutInstances, ChildId, Parent, Name, Depth + 1);
+		}
+		break;
+	case EVoxSceneNodeType::Shape:
+		for (int32 ModelId : Node->Models) {
+			FVoxModelInstance Instance;
+			Instance.ModelId = ModelId;
+			Instance.Name = Name;
+			Instance.Transform = Parent;
+			OutInstances.Add(Instance);
+		}
+		break;
+	}
+}
+
+/**
+ * GetSceneTransform
+ * Vox places model voxels relative to model pivot floor(size / 2) and the
+ * importer mirrors vox axes into unreal axes. Conjugate scene rotation with
+ * the axis mirror and fold pivot and mirror offsets into the translation.
+ * Scene = OutRotation * Local + OutTranslation in unreal axes and voxel units.
+ * @param Instance Model placement
+ * @param Size Model size in unreal axes
+ * @param ImportOption Import option used to read voxels
+ */
+void FVoxScene::GetSceneTransform(const FVoxModelInstance& Instance, const FIntVector& Size, const UVoxImportOption* ImportOption, FVoxRotation& OutRotation, FIntVector& OutTranslation)
+{
+	FVoxRotation Mirror;
+	FIntVector Corner;
+	FIntVector VoxSize;
+	if (ImportOption->bImportXForward) {
+		Mirror.Rows[0] = FIntVector(0, -1, 0);
+		Mirror.Rows[1] = FIntVector(-1, 0, 0);
+		Corner = FIntVector(Size.X, Size.Y, 0);
+		VoxSize = FIntVector(Size.Y, Size.X, Size.Z);
+	} else {
+		Mirror.Rows[0] = FIntVector(-1, 0, 0);
+		Corner = FIntVector(Size.X, 0, 0);
+		VoxSize = Size;
+	}
+	const FIntVector Pivot(VoxSize.X / 2, VoxSize.Y / 2, VoxSize.Z / 2);
+	OutRotation = Mirror * Instance.Transform.Rotation * Mirror;
+	OutTranslation = Mirror * Instance.Transform.Translation - OutRotation * Corner - (Mirror * Instance.Transform.Rotation) * Pivot;
+}
+
+/**
+ * ToUnrealTransform
+ * @param Instance Model placement
+ * @param Size Model size in unreal axes
+ * @param ImportOption Import option used to generate mesh
+ */
+FTransform FVoxScene::ToUnrealTransform(const FVoxModelInstance& Instance, const FIntVector& Size, const UVoxImportOption* ImportOption)
+{
+	FVoxRotation Rotation;
+	FIntVector Translation;
+	GetSceneTransform(Instance, Size, ImportOption, Rotation, Translation);
+
+	const FVector Offset = ImportOption->bImportXYCenter ? FVector((float)Size.X * 0.5f, (float)Size.Y * 0.5f, 0.f) : FVector::ZeroVector;
+	FMatrix Matrix = FMatrix::Identity;
+	for (int32 Axis = 0; Axis < 3; ++Axis) {
+		const FIntVector Basis(Rotation.Rows[0][Axis], Rotation.Rows[1][Axis], Rotation.Rows[2][Axis]);
+		Matrix.SetAxis(Axis, FVector(Basis));
+	}
+	Matrix.SetOrigin((Matrix.TransformVector(Offset) + FVector(Translation)) * ImportOption->Scale);
+	return FTransform(Matrix);
+}
+
+/**
+ * Merge
+ * Place every model instance into one scene grid and split it back to one
+ * vox per instance. Cells of other instances next to the instance surface
+ * are stored as occluder to cull faces hidden by adjacent models.
+ * @param Sizes Size of each model in unreal axes
+ * @param Voxels Voxels of each model
+ * @param ImportOption Import option used to read voxels
+ * @param OutVoxes Out vox in scene space for each instance
+ * @param OutNames Out instance name, empty if unnamed
+ */
+void FVoxScene::Merge(const TArray<FIntVector>& Sizes, const TArray<TMap<FIntVector, uint8>>& Voxels, const UVoxImportOption* ImportOption, TArray<FVox>& OutVoxes, TArray<FString>& OutNames) const
+{
+	TArray<FVoxModelInstance> Instances;
+	GetInstances(Instances);
+	Instances.RemoveAll([&](const FVoxModelInstance& Instance) {
+		return !Sizes.IsValidIndex(Instance.ModelId) || !Voxels.IsValidIndex(Instance.ModelId);
+	});
+
+	TArray<TMap<FIntVector, uint8>> Pieces;
+	TArray<FIntVector> Mins;
+	TSet<FIntVector> Scene;
+	FIntVector SceneMin(MAX_int32), SceneMax(MIN_int32);
+	for (const FVoxModelInstance& Instance : Instances) {
+		FVoxRotation Rotation;
+		FIntVector Translation;
+		GetSceneTransform(Instance, Sizes[Instance.ModelId], ImportOption, Rotation, Translation);
+		//cell [u, u + 1] maps to box with min corner at rotated unit offset below zero
+		FIntVector CellOffset = Rotation * FIntVector(1, 1, 1);
+		CellOffset = FIntVector(FMath::Min(CellOffset.X, 0), FMath::Min(CellOffset.Y, 0), FMath::Min(CellOffset.Z, 0));
+
+		TMap<FIntVector, uint8>& Piece = Pieces[Pieces.AddDefaulted()];
+		FIntVector& Min = Mins[Mins.Add(FIntVector(MAX_int32))];
+		Piece.Reserve(Voxels[Instance.ModelId].Num());
+		for (const auto& Cell : Voxels[Instance.ModelId]) {
+			const FIntVector SceneCell = Rotation * Cell.Key + Translation + CellOffset;
+			Piece.Add(SceneCell, Cell.Value);
+			Scene.Add(SceneCell);
+			Min = FIntVector(FMath::Min(Min.X, SceneCell.X), FMath::Min(Min.Y, SceneCell.Y), FMath::Min(Min.Z, SceneCell.Z));
+			SceneMin = FIntVector(FMath::Min(SceneMin.X, SceneCell.X), FMath::Min(SceneMin.Y, SceneCell.Y), FMath::Min(SceneMin.Z, SceneCell.Z));
+			SceneMax = FIntVector(FMath::Max(SceneMax.X, SceneCell.X), FMath::Max(SceneMax.Y, SceneCell.Y), FMath::Max(SceneMax.Z, SceneCell.Z));
+		}
+	}
+
+	static const FIntVector Directions[6] = {
+		FIntVector(0, 0, 1), FIntVector(0, 0, -1),
+		FIntVector(1, 0, 0), FIntVector(-1, 0, 0),
+		FIntVector(0, 1, 0), FIntVector(0, -1, 0),
+	};
+	const FVector SceneCenter = ImportOption->bImportXYCenter ? FVector((float)(SceneMin.X + SceneMax.X + 1) * 0.5f, (float)(SceneMin.Y + SceneMax.Y + 1) * 0.5f, (float)SceneMin.Z) : FVector::ZeroVector;
+	for (int32 i = 0; i < Pieces.Num(); ++i) {
+		if (Pieces[i].Num() == 0) continue;
+		const FIntVector& Min = Mins[i];
+		FVox& Vox = OutVoxes[OutVoxes.AddDefaulted()];
+		Vox.Voxel.Reserve(Pieces[i].Num());
+		FIntVector Max(MIN_int32);
+		for (const auto& Cell : Pieces[i]) {
+			Vox.Voxel.Add(Cell.Key - Min, Cell.Value);
+			Max = FIntVector(FMath::Max(Max.X, Cell.Key.X), FMath::Max(Max.Y, Cell.Key.Y), FMath::Max(Max.Z, Cell.Key.Z));
+			for (const FIntVector& Direction : Directions) {
+				const FIntVector Neighbor = Cell.Key + Direction;
+				if (!Pieces[i].Contains(Neighbor) && Scene.Contains(Neighbor)) {
+					Vox.Occluder.Add(Neighbor - Min);
+				}
+			}
+		}
+		Vox.Size = Max - Min + FIntVector(1, 1, 1);
+		Vox.SceneOffset = FVector(Min) - SceneCenter;
+		OutNames.Add(Instances[i].Name);
+	}
+}
@@ -0,0 +1,126 @@
+// Copyright 2016-2018 mik14a / Admix Network. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FVox;
+class UVoxImportOption;
+
+/**
+ * @struct FVoxRotation
+ * Rotation matrix of scene graph, rows contain single +1 or -1.
+ */
+struct FVoxRotation
+{
+	/** Matrix rows */
+	FIntVector Rows[3];
+
+	/** Identity rotation */
+	FVoxRotation();
+
+	/** Decode packed rotation byte of transform node frame */
+	static FVoxRotation FromPacked(uint8 Packed);
+
+	/** Rotate vector */
+	FIntVector operator*(const FIntVector& Vector) const;
+
+	/** Concatenate rotations */
+	FVoxRotation operator*(const FVoxRotation& Other) const;
+};
+
+/**
+ * @struct FVoxTransform
+ * Rigid transform in vox space. World = Translation + Rotation * Local
+ */
+struct FVoxTransform
+{
+	FVoxRotation Rotation;
+	FIntVector Translation;
+
+	FVoxTransform() : Rotation(), Translation(ForceInitToZero) { }
+
+	/** Concatenate parent * child */
+	FVoxTransform operator*(const FVoxTransform& Child) const;
+};
+
+/** Scene graph node type */
+enum class EVoxSceneNodeType : uint8
+{
+	Transform,
+	Group,
+	Shape,
+};
+
+/**
+ * @struct FVoxSceneNode
+ * Node of nTRN, nGRP or nSHP chunk.
+ */
+struct FVoxSceneNode
+{
+	EVoxSceneNodeType Type;
+	/** Name of transform node */
+	FString Name;
+	/** Hidden transform node */
+	bool bHidden;
+	/** Transform of first frame */
+	FVoxTransform Transform;
+	/** Child nodes of transform and group node */
+	TArray<int32> Children;
+	/** Model ids of shape node */
+	TArray<int32> Models;
+
+	FVoxSceneNode() : Type(EVoxSceneNodeType::Group), bHidden(false) { }
+};
+
+/**
+ * @struct FVoxModelInstance
+ * Placement of model in scene.
+ */
+struct FVoxModelInstance
+{
+	/** Index of SIZE and XYZI chunk */
+	int32 ModelId;
+	/** Name of nearest transform node */
+	FString Name;
+	/** Model to world transform in vox space */
+	FVoxTransform Transform;
+};
+
+/**
+ * @struct FVoxScene
+ * Scene graph of vox file.
+ * @see https://github.com/ephtracy/voxel-model/blob/master/MagicaVoxel-file-format-vox-extension.txt
+ */
+struct FVoxScene
+{
+	/** Nodes by node id */
+	TMap<int32, FVoxSceneNode> Nodes;
+
+public:
+
+	/** Read nTRN chunk contents and return node id */
+	int32 ReadTransformNode(FArchive& Ar);
+
+	/** Read nGRP chunk contents and return node id */
+	int32 ReadGroupNode(FArchive& Ar);
+
+	/** Read nSHP chunk contents and return node id */
+	int32 ReadShapeNode(FArchive& Ar);
+
+	/** Collect every visible model placement from root node */
+	void GetInstances(TArray<FVoxModelInstance>& OutInstances) const;
+
+	/** Place every model instance into one grid and split it to vox per instance with cells of adjacent models as occluder */
+	void Merge(const TArray<FIntVector>& Sizes, const TArray<TMap<FIntVector, uint8>>& Voxels, const UVoxImportOption* ImportOption, TArray<FVox>& OutVoxes, TArray<FString>& OutNames) const;
+
+	/** Get integer transform from model cells to scene cells in unreal axes */
+	static void GetSceneTransform(const FVoxModelInstance& Instance, const FIntVector& Size, const UVoxImportOption* ImportOption, FVoxRotation& OutRotation, FIntVector& OutTranslation);
+
+	/** Convert instance transform to unreal transform of mesh generated with import option */
+	static FTransform ToUnrealTransform(const FVoxModelInstance& Instance, const FIntVector& Size, const UVoxImportOption* ImportOption);
+
+private:
+
+	void GetInstances(TArray<FVoxModelInstance>& OutInstances, int32 NodeId, const FVoxTransform& Parent, const FString& Name, int32 Depth) const;
+};
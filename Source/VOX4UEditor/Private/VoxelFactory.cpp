@@ -2,26 +2,74 @@
 
 #include "VoxelFactory.h"
 #include <ApexDestructibleAssetImport.h>
+#include <Async/ParallelFor.h>
+#include <Components/HierarchicalInstancedStaticMeshComponent.h>
+#include <DerivedDataCacheInterface.h>
 #include <DestructibleMesh.h>
+#include <DistanceFieldAtlas.h>
 #include <Editor.h>
 #include <EditorFramework/AssetImportData.h>
+#include <Engine/Blueprint.h>
+#include <Engine/BlueprintGeneratedClass.h>
+#include <Engine/SCS_Node.h>
+#include <Engine/SimpleConstructionScript.h>
 #include <Engine/SkeletalMesh.h>
 #include <Engine/StaticMesh.h>
 #include <HAL/FileManager.h>
+#include <HAL/IConsoleManager.h>
+#include <Kismet2/KismetEditorUtilities.h>
 #include <Materials/MaterialExpressionVectorParameter.h>
+#include <Materials/MaterialExpressionMultiply.h>
+#include <Materials/MaterialExpressionVertexColor.h>
 #include <Materials/MaterialInstanceConstant.h>
+#include <Misc/SecureHash.h>
 #include <PhysicsEngine/BodySetup.h>
 #include <PhysicsEngine/BoxElem.h>
 #include <RawMesh.h>
+#include <Serialization/MemoryReader.h>
+#include <Serialization/MemoryWriter.h>
 #include "VOX.h"
 #include "VoxAssetImportData.h"
+#include "VoxCoreAdapter.h"
 #include "VoxImportOption.h"
 #include "Voxel.h"
+#include "VoxelDistanceFieldUserData.h"
+#include "VoxelMeshComponent.h"
 #include "AssetRegistryModule.h"
 #include "Runtime/Engine/Classes/PhysicsEngine/BodySetup.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogVoxelFactory, Log, All)
 
+/** Change to invalidate raw meshes stored in derived data cache */
+#define VOX_DERIVEDDATA_VER TEXT("5E2B9C1A47D84F3AB6E0C2D19F7A3E41")
+
+/**
+ * AppendRawMesh
+ * Append faces of raw mesh using single material index
+ * @param OutRawMesh Raw mesh to append to
+ * @param RawMesh Raw mesh to append
+ * @param MaterialIndex Material index of appended faces
+ */
+static void AppendRawMesh(FRawMesh& OutRawMesh, const FRawMesh& RawMesh, int32 MaterialIndex)
+{
+	const uint32 VertexOffset = OutRawMesh.VertexPositions.Num();
+	OutRawMesh.VertexPositions.Append(RawMesh.VertexPositions);
+	for (uint32 Index : RawMesh.WedgeIndices) {
+		OutRawMesh.WedgeIndices.Add(Index + VertexOffset);
+	}
+	OutRawMesh.WedgeTangentX.Append(RawMesh.WedgeTangentX);
+	OutRawMesh.WedgeTangentY.Append(RawMesh.WedgeTangentY);
+	OutRawMesh.WedgeTangentZ.Append(RawMesh.WedgeTangentZ);
+	for (int32 i = 0; i < MAX_MESH_TEXTURE_COORDS; ++i) {
+		OutRawMesh.WedgeTexCoords[i].Append(RawMesh.WedgeTexCoords[i]);
+	}
+	OutRawMesh.WedgeColors.Append(RawMesh.WedgeColors);
+	for (int32 i = 0; i < RawMesh.FaceMaterialIndices.Num(); ++i) {
+		OutRawMesh.FaceMaterialIndices.Add(MaterialIndex);
+	}
+	OutRawMesh.FaceSmoothingMasks.Append(RawMesh.FaceSmoothingMasks);
+}
+
 UVoxelFactory::UVoxelFactory(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, ImportOption(nullptr)
@@ -59,6 +107,8 @@ UClass* UVoxelFactory::ResolveSupportedClass()
 		Class = UDestructibleMesh::StaticClass();
 	} else if (ImportOption->VoxImportType == EVoxImportType::Voxel) {
 		Class = UVoxel::StaticClass();
+	} else if (ImportOption->VoxImportType == EVoxImportType::Animation) {
+		Class = UStaticMesh::StaticClass();
 	}
 	return Class;
 }
@@ -67,16 +117,21 @@ UObject* UVoxelFactory::FactoryCreateBinary(UClass* InClass, UObject* InParent,
 {
 	UObject* Result = nullptr;	
 	GEditor->GetEditorSubsystem<UImportSubsystem>()->BroadcastAssetPreImport(this, InClass, InParent, InName, Type);
+	Statistics.Reset();
 
 	bool bImportAll = true;
 	if (!bShowOption || ImportOption->GetImportOption(bImportAll)) {
 		bShowOption = !bImportAll;
 		FBufferReader Reader((void*)Buffer, BufferEnd - Buffer, false);		
-		if (bImportAll)
+		if (ImportOption->VoxImportType == EVoxImportType::Animation)
+		{
+			FVoxProjectFile voxArch(ImportVoxProject(Reader));
+			if (voxArch.valid) {
+				Result = CreateAnimation(InParent, InName, Flags, voxArch);
+			}
+		} else if (bImportAll)
 		{
 			FVoxProjectFile voxArch(ImportVoxProject(Reader));
-			bool importMaterials = ImportOption->bImportMaterial;
-			UMaterialInterface* mat = nullptr;
 			TArray<UObject*> AllNewAssets;
 			UObject* asset = nullptr;
 			FString assetPath, absPath;
@@ -84,32 +139,102 @@ UObject* UVoxelFactory::FactoryCreateBinary(UClass* InClass, UObject* InParent,
 			GetPackagePaths(InParent, &absPath, &assetPath);
 			FPackageName::RegisterMountPoint(*assetPath, *absPath);
 
-			if (voxArch.valid) for (int32 i = 0; i < voxArch.voxels.Num(); ++i) {
-				
-				FName leName = InName;
+			TArray<FVox> Voxes;
+			TArray<FName> Names;
+			const bool bMergeScene = ImportOption->VoxImportType == EVoxImportType::StaticMesh && ImportOption->bMergeScene && voxArch.scene.Nodes.Num() > 0;
+			if (voxArch.valid && bMergeScene) {
+				//one mesh per placement in scene space, faces hidden by adjacent models are culled
+				TArray<FString> InstanceNames;
+				voxArch.scene.Merge(voxArch.sizes, voxArch.voxels, ImportOption, Voxes, InstanceNames);
+				const FString BaseName = FPaths::GetBaseFilename(voxArch.archiveName);
+				for (int32 i = 0; i < Voxes.Num(); ++i) {
+					FVox& Vox = Voxes[i];
+					Vox.Filename = GetCurrentFilename();
+					Vox.modelName = InstanceNames[i].IsEmpty() ? FString::Printf(TEXT("%s_%d"), *BaseName, i) : InstanceNames[i];
+					Vox.Palette = voxArch.palette;
+					Names.Add(*Vox.modelName);
+					Statistics.AddModel(Vox.Voxel.Num());
+				}
+			} else if (voxArch.valid) for (int32 i = 0; i < voxArch.voxels.Num(); ++i) {
 				FString modelName = voxArch.GetName(i);
 				if (modelName.IsEmpty()) modelName = FPaths::GetBaseFilename(voxArch.archiveName);				
-				leName = *modelName;
 
-				FVox Vox;
+				FVox& Vox = Voxes[Voxes.AddDefaulted()];
 				Vox.Filename = GetCurrentFilename();
 				Vox.Size = voxArch.sizes[i];
 				Vox.Voxel = voxArch.voxels[i];
 				Vox.modelName = modelName;
 				Vox.Palette = voxArch.palette;
-				
-				//import material only for first model if any
-				ImportOption->bImportMaterial = importMaterials && i == 0;
+				Names.Add(*modelName);
+				Statistics.AddModel(Vox.Voxel.Num());
+			}
+
+			//mesh all models on worker threads, only uobject creation and build stay on game thread
+			TArray<FString> SourceHashes;
+			TArray<int32> SharedModels;
+			TArray<UPackage*> Packages;
+			TArray<UStaticMesh*> UpToDateMeshes;
+			TArray<FRawMesh> RawMeshes;
+			TArray<TUniquePtr<FDistanceFieldVolumeData>> DistanceFields;
+			TArray<UStaticMesh*> Meshes;
+			if (ImportOption->VoxImportType == EVoxImportType::StaticMesh) {
+				SourceHashes.SetNum(Voxes.Num());
+				ParallelFor(Voxes.Num(), [&](int32 i) {
+					SourceHashes[i] = Voxes[i].ComputeHash(ImportOption);
+				});
+				//scene placement references identical models by single mesh
+				TMap<FString, int32> FirstModels;
+				for (int32 i = 0; i < Voxes.Num(); ++i) {
+					SharedModels.Add(ImportOption->bImportScene && !bMergeScene ? FirstModels.FindOrAdd(SourceHashes[i], i) : i);
+				}
+				//names stay same between imports so reimport finds meshes of last one
+				TSet<FName> UsedNames;
+				for (int32 i = 0; i < Voxes.Num(); ++i) {
+					if (SharedModels[i] != i) {
+						Packages.Add(nullptr);
+						UpToDateMeshes.Add(nullptr);
+						continue;
+					}
+					if (UsedNames.Contains(Names[i])) {
+						Names[i] = *FString::Printf(TEXT("%s_%d"), *Names[i].ToString(), i);
+					}
+					UsedNames.Add(Names[i]);
+					Packages.Add(CreatePackage(nullptr, *(assetPath + Names[i].ToString())));
+					UpToDateMeshes.Add(FindUpToDateStaticMesh(Packages[i], Names[i], SourceHashes[i]));
+				}
+				RawMeshes.SetNum(Voxes.Num());
+				DistanceFields.SetNum(Voxes.Num());
+				ParallelFor(Voxes.Num(), [&](int32 i) {
+					if (SharedModels[i] == i && !UpToDateMeshes[i]) {
+						GetOptimizedRawMesh(RawMeshes[i], &Voxes[i], SourceHashes[i]);
+						DistanceFields[i] = CreateDistanceField(&Voxes[i]);
+					}
+				});
+				Statistics.SampleMemory();
+				Meshes.SetNumZeroed(Voxes.Num());
+			}
+
+			for (int32 i = 0; i < Voxes.Num(); ++i) {
+				FName leName = Names[i];
+				FVox& Vox = Voxes[i];
 
 				UPackage * Package = nullptr;		
+				bool bUpToDate = false;
 
 				switch (ImportOption->VoxImportType) {
 				case EVoxImportType::StaticMesh:
-					{
-						leName = MakeUniqueObjectName(this, UStaticMesh::StaticClass(), leName);
-						UStaticMesh* mesh;
-						Package = CreatePackage(nullptr, *(assetPath + leName.ToString()));
-						mesh = CreateStaticMesh(Package, leName, Flags | RF_Standalone, &Vox);						
+					if (SharedModels[i] != i) {
+						Meshes[i] = Meshes[SharedModels[i]];
+						continue;
+					} else {
+						UStaticMesh* mesh = UpToDateMeshes[i];
+						Package = Packages[i];
+						bUpToDate = mesh != nullptr;
+						if (!bUpToDate) {
+							mesh = CreateStaticMesh(Package, leName, Flags | RF_Standalone, &Vox, RawMeshes[i], SourceHashes[i], DistanceFields[i].IsValid());
+							RawMeshes[i].Empty();
+						}
+						Meshes[i] = mesh;
 						asset = mesh;						
 					}
 					break;
@@ -130,33 +255,33 @@ UObject* UVoxelFactory::FactoryCreateBinary(UClass* InClass, UObject* InParent,
 					FAssetRegistryModule::AssetCreated(asset);
 					asset->MarkPackageDirty();					
 				}
+				if (bUpToDate) {
+					AllNewAssets.Add(asset);
+					continue;
+				}
 				asset->Modify();
 				asset->PostEditChange();
+				if (DistanceFields.IsValidIndex(i) && DistanceFields[i]) {
+					//after last build of the mesh, user data applies it to later ones
+					AttachDistanceField(Meshes[i], MoveTemp(DistanceFields[i]));
+				}
 				if (Package) Package->MarkPackageDirty();
 				AllNewAssets.Add(asset);
-				
-				//attempt to assign same material to all imported meshes, prolly they need to be saved before material can be assigned				
-				/*
-				if (importMaterials && i == 0) {
-					//if this is first model then save the material ref
-					UStaticMesh* mesh = Cast<UStaticMesh>(Result);
-					if (mesh)
-						mat = mesh->GetMaterial(0)->GetMaterial();
-				}
-				if (importMaterials && i > 0)
-				{
-					//for rest of models use material from first one
-					UStaticMesh* mesh = Cast<UStaticMesh>(Result);
-					if (mesh && mat) {
-						mesh->StaticMaterials.Add(mat);
-						mesh->SetMaterial(0, mat);
-					}
-				}
-				*/
 			}					
+
+			if (ImportOption->VoxImportType == EVoxImportType::StaticMesh && ImportOption->bImportScene && !bMergeScene) {
+				const FName SceneName = *(FPaths::GetBaseFilename(voxArch.archiveName) + TEXT("_BP"));
+				UPackage* ScenePackage = CreatePackage(nullptr, *(assetPath + SceneName.ToString()));
+				if (UBlueprint* Blueprint = CreateSceneBlueprint(ScenePackage, SceneName, Flags | RF_Standalone, voxArch, Meshes)) {
+					FAssetRegistryModule::AssetCreated(Blueprint);
+					ScenePackage->MarkPackageDirty();
+					AllNewAssets.Add(Blueprint);
+				}
+			}
 		} else
 		{
 			FVox Vox(GetCurrentFilename(), Reader, ImportOption, false);
+			Statistics.AddModel(Vox.Voxel.Num());
 			switch (ImportOption->VoxImportType) {
 			case EVoxImportType::StaticMesh:
 				Result = CreateStaticMesh(InParent, InName, Flags, &Vox);
@@ -175,6 +300,9 @@ UObject* UVoxelFactory::FactoryCreateBinary(UClass* InClass, UObject* InParent,
 			}
 		}
 	}		
+	if (Result) {
+		Statistics.Log(GetCurrentFilename());
+	}
 	GEditor->GetEditorSubsystem<UImportSubsystem>()->BroadcastAssetPostImport(this, Result);
 	return Result;
 }
@@ -267,24 +395,171 @@ EReimportResult::Type UVoxelFactory::Reimport(UObject* Obj)
 
 UStaticMesh* UVoxelFactory::CreateStaticMesh(UObject* InParent, FName InName, EObjectFlags Flags, const FVox* Vox) const
 {
+	const FString SourceHash = Vox->ComputeHash(ImportOption);
+	if (UStaticMesh* UpToDateMesh = FindUpToDateStaticMesh(InParent, InName, SourceHash)) {
+		return UpToDateMesh;
+	}
+
+	FRawMesh RawMesh;
+	GetOptimizedRawMesh(RawMesh, Vox, SourceHash);
+	TUniquePtr<FDistanceFieldVolumeData> DistanceField = CreateDistanceField(Vox);
+	Statistics.SampleMemory();
+	UStaticMesh* StaticMesh = CreateStaticMesh(InParent, InName, Flags, Vox, RawMesh, SourceHash, DistanceField.IsValid());
+	if (DistanceField) {
+		AttachDistanceField(StaticMesh, MoveTemp(DistanceField));
+	}
+	return StaticMesh;
+}
+
+/**
+ * CreateStaticMesh
+ * Create static mesh from already generated raw mesh. Must be called on game thread.
+ * @param InParent Import package
+ * @param InName Object name
+ * @param Flags Import flags
+ * @param Vox Voxel file data
+ * @param RawMesh Raw mesh generated from voxel data, one material slot per material index
+ * @param SourceHash Hash of voxel data to store in import data
+ * @param bVoxelDistanceField Build with resolution scale 0 for voxel field attached later
+ * @param NumFrames Num of material slots of animation, one per frame
+ */
+UStaticMesh* UVoxelFactory::CreateStaticMesh(UObject* InParent, FName InName, EObjectFlags Flags, const FVox* Vox, FRawMesh& RawMesh, const FString& SourceHash, bool bVoxelDistanceField, int32 NumFrames) const
+{
+	check(IsInGameThread());
 	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(InParent, InName, Flags | RF_Public);
 	if (!StaticMesh->AssetImportData || !StaticMesh->AssetImportData->IsA<UVoxAssetImportData>()) {
 		auto AssetImportData = NewObject<UVoxAssetImportData>(StaticMesh);
 		AssetImportData->FromVoxImportOption(*ImportOption);
 		StaticMesh->AssetImportData = AssetImportData;
 	}
+	CastChecked<UVoxAssetImportData>(StaticMesh->AssetImportData)->SourceHash = SourceHash;
 
-	FRawMesh RawMesh;
-	Vox->CreateOptimizedRawMesh(RawMesh, ImportOption);
+	Statistics.AddRawMesh(RawMesh);
 	UMaterialInterface* Material = CreateMaterial(InParent, InName, Flags, Vox);
-	StaticMesh->StaticMaterials.Add(FStaticMaterial(Material));
-	BuildStaticMesh(StaticMesh, RawMesh);
+	Statistics.SampleMemory();
+	if (ImportOption->bGroupByDirection && ImportOption->VoxImportType != EVoxImportType::Animation) {
+		//every direction keeps its slot even without faces so section material index is direction
+		for (const FName& SlotName : UVoxelMeshComponent::DirectionSlotNames) {
+			StaticMesh->StaticMaterials.Add(FStaticMaterial(Material, SlotName, SlotName));
+		}
+	} else {
+		int32 NumMaterials = 1;
+		if (ImportOption->VoxImportType == EVoxImportType::Animation) {
+			//frame N is slot N, empty frames have no faces but keep their slot
+			NumMaterials = FMath::Max(NumFrames, 1);
+		} else {
+			for (int32 MaterialIndex : RawMesh.FaceMaterialIndices) {
+				NumMaterials = FMath::Max(NumMaterials, MaterialIndex + 1);
+			}
+		}
+		for (int32 i = 0; i < NumMaterials; ++i) {
+			StaticMesh->StaticMaterials.Add(FStaticMaterial(Material));
+		}
+	}
+	//field of earlier import is replaced by attach or dropped
+	StaticMesh->RemoveUserDataOfClass(UVoxelDistanceFieldUserData::StaticClass());
+	BuildStaticMesh(StaticMesh, RawMesh, bVoxelDistanceField);
+	Statistics.SampleMemory();
+	Statistics.AddStaticMesh(StaticMesh);
 	if (ImportOption->bComplexCollisionAsSimple)
 		StaticMesh->BodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
 	StaticMesh->AssetImportData->Update(Vox->Filename);	
 	return StaticMesh;
 }
 
+/**
+ * FindUpToDateStaticMesh
+ * Find existing static mesh built from same voxel data and import options,
+ * loading it from package on disk when not loaded.
+ * @param InParent Import package
+ * @param InName Object name
+ * @param SourceHash Hash of voxel data to import
+ * @return Existing mesh to reuse or nullptr to build new one
+ */
+UStaticMesh* UVoxelFactory::FindUpToDateStaticMesh(UObject* InParent, FName InName, const FString& SourceHash) const
+{
+	UStaticMesh* StaticMesh = FindObject<UStaticMesh>(InParent, *InName.ToString());
+	if (!StaticMesh && FPackageName::DoesPackageExist(InParent->GetOutermost()->GetName())) {
+		//mesh of earlier import saved but not loaded
+		StaticMesh = LoadObject<UStaticMesh>(InParent, *InName.ToString(), nullptr, LOAD_NoWarn | LOAD_Quiet);
+	}
+	if (!StaticMesh || !StaticMesh->RenderData) {
+		return nullptr;
+	}
+	UVoxAssetImportData* AssetImportData = Cast<UVoxAssetImportData>(StaticMesh->AssetImportData);
+	if (!AssetImportData || AssetImportData->SourceHash != SourceHash) {
+		return nullptr;
+	}
+	UE_LOG(LogVoxelFactory, Verbose, TEXT("%s is up to date. Skip mesh generation."), *InName.ToString());
+	AssetImportData->Update(GetCurrentFilename());
+	return StaticMesh;
+}
+
+/**
+ * CreateAnimation
+ * Create static mesh containing every model of the project as animation
+ * frame. Frames share one vertex and index buffer, frame N is the section
+ * of material slot N. Play it with UVoxelAnimationComponent.
+ * @param InParent Import package
+ * @param InName Object name
+ * @param Flags Import flags
+ * @param Project Vox project contains frames
+ */
+UStaticMesh* UVoxelFactory::CreateAnimation(UObject* InParent, FName InName, EObjectFlags Flags, const FVoxProjectFile& Project) const
+{
+	//frames share the largest size so centering does not shift between frames
+	FIntVector Size = FIntVector::ZeroValue;
+	for (const FIntVector& FrameSize : Project.sizes) {
+		Size = FIntVector(FMath::Max(Size.X, FrameSize.X), FMath::Max(Size.Y, FrameSize.Y), FMath::Max(Size.Z, FrameSize.Z));
+	}
+	TArray<FVox> Frames;
+	for (int32 i = 0; i < Project.voxels.Num(); ++i) {
+		//cells were mirrored in own size, mirror them in shared one
+		const FIntVector Shift(Size.X - Project.sizes[i].X, ImportOption->bImportXForward ? Size.Y - Project.sizes[i].Y : 0, 0);
+		FVox& Frame = Frames[Frames.AddDefaulted()];
+		Frame.Filename = GetCurrentFilename();
+		Frame.Size = Size;
+		Frame.Voxel.Reserve(Project.voxels[i].Num());
+		for (const auto& Cell : Project.voxels[i]) {
+			Frame.Voxel.Add(Cell.Key + Shift, Cell.Value);
+		}
+		Frame.Palette = Project.palette;
+		Statistics.AddModel(Frame.Voxel.Num());
+	}
+	if (Frames.Num() == 0) {
+		return nullptr;
+	}
+
+	TArray<FString> FrameHashes;
+	FrameHashes.SetNum(Frames.Num());
+	ParallelFor(Frames.Num(), [&](int32 i) {
+		FrameHashes[i] = Frames[i].ComputeHash(ImportOption);
+	});
+	FSHA1 Sha;
+	for (const FString& FrameHash : FrameHashes) {
+		Sha.UpdateWithString(*FrameHash, FrameHash.Len());
+	}
+	Sha.Final();
+	FSHAHash Hash;
+	Sha.GetHash(Hash.Hash);
+	const FString SourceHash = Hash.ToString();
+	if (UStaticMesh* UpToDateMesh = FindUpToDateStaticMesh(InParent, InName, SourceHash)) {
+		return UpToDateMesh;
+	}
+
+	TArray<FRawMesh> RawMeshes;
+	RawMeshes.SetNum(Frames.Num());
+	ParallelFor(Frames.Num(), [&](int32 i) {
+		GetOptimizedRawMesh(RawMeshes[i], &Frames[i], FrameHashes[i]);
+	});
+	Statistics.SampleMemory();
+	FRawMesh RawMesh;
+	for (int32 i = 0; i < RawMeshes.Num(); ++i) {
+		AppendRawMesh(RawMesh, RawMeshes[i], i);
+	}
+	return CreateStaticMesh(InParent, InName, Flags, &Frames[0], RawMesh, SourceHash, false, Frames.Num());
+}
+
 USkeletalMesh* UVoxelFactory::CreateSkeletalMesh(UObject* InParent, FName InName, EObjectFlags Flags, const FVox* Vox) const
 {
 	USkeletalMesh* SkeletalMesh = NewObject<USkeletalMesh>(InParent, InName, Flags | RF_Public);
@@ -316,7 +591,8 @@ UDestructibleMesh* UVoxelFactory::CreateDestructibleMesh(UObject* InParent, FNam
 	}
 
 	FRawMesh RawMesh;
-	Vox->CreateOptimizedRawMesh(RawMesh, ImportOption);
+	GetOptimizedRawMesh(RawMesh, Vox, Vox->ComputeHash(ImportOption));
+	Statistics.AddRawMesh(RawMesh);
 	UMaterialInterface* Material = CreateMaterial(InParent, InName, Flags, Vox);
 	UStaticMesh* RootMesh = NewObject<UStaticMesh>();
 	RootMesh->StaticMaterials.Add(FStaticMaterial(Material));
@@ -327,6 +603,7 @@ UDestructibleMesh* UVoxelFactory::CreateDestructibleMesh(UObject* InParent, FNam
 	Vox->CreateRawMeshes(RawMeshes, ImportOption);
 	TArray<UStaticMesh*> FractureMeshes;
 	for (FRawMesh& RawMesh : RawMeshes) {
+		Statistics.AddRawMesh(RawMesh);
 		UStaticMesh* FructureMesh = NewObject<UStaticMesh>();
 		FructureMesh->StaticMaterials.Add(FStaticMaterial(Material));
 		BuildStaticMesh(FructureMesh, RawMesh);
@@ -373,6 +650,7 @@ UVoxel* UVoxelFactory::CreateVoxel(UObject* InParent, FName InName, EObjectFlags
 
 		FRawMesh RawMesh;
 		FVox::CreateMesh(RawMesh, ImportOption);
+		Statistics.AddRawMesh(RawMesh);
 		UStaticMesh* StaticMesh = NewObject<UStaticMesh>(InParent, *FString::Printf(TEXT("%s_SM%d"), *InName.GetPlainNameString(), color), Flags | RF_Public);
 		StaticMesh->StaticMaterials.Add(FStaticMaterial(MaterialInstance));
 		BuildStaticMesh(StaticMesh, RawMesh);
@@ -387,225 +665,299 @@ UVoxel* UVoxelFactory::CreateVoxel(UObject* InParent, FName InName, EObjectFlags
 		Voxel->Voxel.Add(cell.Key, Palette.IndexOfByKey(cell.Value));
 		check(INDEX_NONE != Palette.IndexOfByKey(cell.Value));
 	}
+	Voxel->BuildGrid();
 	Voxel->bXYCenter = ImportOption->bImportXYCenter;
 	Voxel->CalcCellBounds();
 	Voxel->AssetImportData->Update(Vox->Filename);
 	return Voxel;
 }
 
-UStaticMesh* UVoxelFactory::BuildStaticMesh(UStaticMesh* OutStaticMesh, FRawMesh& RawMesh) const
+UStaticMesh* UVoxelFactory::BuildStaticMesh(UStaticMesh* OutStaticMesh, FRawMesh& RawMesh, bool bVoxelDistanceField) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_BuildStaticMesh);
 	check(OutStaticMesh);
 	FStaticMeshSourceModel* StaticMeshSourceModel = new(OutStaticMesh->SourceModels) FStaticMeshSourceModel();
 	StaticMeshSourceModel->BuildSettings = ImportOption->GetBuildSettings();
+	if (bVoxelDistanceField) {
+		//engine builds empty field without tracing triangles
+		StaticMeshSourceModel->BuildSettings.DistanceFieldResolutionScale = 0.f;
+	}
+	const int32 LightmapResolution = FVoxCoreAdapter::GetLightmapResolution(RawMesh);
+	if (0 < LightmapResolution) {
+		//voxel charts packed by mesher instead of engine unwrapping
+		StaticMeshSourceModel->BuildSettings.bGenerateLightmapUVs = false;
+		OutStaticMesh->LightMapCoordinateIndex = 1;
+		OutStaticMesh->LightMapResolution = LightmapResolution;
+	}
 	StaticMeshSourceModel->RawMeshBulkData->SaveRawMesh(RawMesh);
 	TArray<FText> Errors;
 	OutStaticMesh->Build(false, &Errors);
 	return OutStaticMesh;
 }
 
-UMaterialInterface* UVoxelFactory::CreateMaterial(UObject* InParent, FName& InName, EObjectFlags Flags, const FVox* Vox) const
+/**
+ * CreateDistanceField
+ * Distance field of voxel data to replace the one engine traces from
+ * triangles. Thread safe.
+ * @param Vox Voxel data
+ * @return nullptr if disabled by option or project or if there is no cell
+ */
+TUniquePtr<FDistanceFieldVolumeData> UVoxelFactory::CreateDistanceField(const FVox* Vox) const
 {
-	if (ImportOption->bImportMaterial) {
-
-		FString assetPath, absPath;
-
-		GetPackagePaths(InParent, &absPath, &assetPath);
-		UPackage* matPackage = CreatePackage(nullptr, *(assetPath + InName.ToString() + FString::Printf(TEXT("%s_MT"))));
-		UMaterial* Material = NewObject<UMaterial>(matPackage, *FString::Printf(TEXT("%s_MT"), *InName.GetPlainNameString()), Flags | RF_Public | RF_Standalone);
-
-		UPackage* texPackage = CreatePackage(nullptr, *(assetPath + InName.ToString() + FString::Printf(TEXT("%s_TX"))));
-		UTexture2D * Texture = NewObject<UTexture2D>(texPackage, *FString::Printf(TEXT("%s_TX"), *InName.GetPlainNameString()), Flags | RF_Public | RF_Standalone);
-		
-		if (Vox->CreateTexture(Texture, ImportOption)) {
-			Material->TwoSided = false;
-			Material->SetShadingModel(MSM_DefaultLit);
-			UMaterialExpressionTextureSample* Expression = NewObject<UMaterialExpressionTextureSample>(Material);
-			Material->Expressions.Add(Expression);
-			Material->BaseColor.Expression = Expression;
-			Expression->Texture = Texture;
-			Material->PostEditChange();
-			Material->MarkPackageDirty();
-
-			Texture->PostEditChange();
-			Texture->MarkPackageDirty();
-		}
-		return Material;
+	static const auto CVarGenerate = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("r.GenerateMeshDistanceFields"));
+	if (!ImportOption->bVoxelDistanceField || !CVarGenerate || CVarGenerate->GetValueOnAnyThread() == 0) {
+		return nullptr;
+	}
+	TUniquePtr<FDistanceFieldVolumeData> DistanceField = MakeUnique<FDistanceFieldVolumeData>();
+	if (!Vox->CreateDistanceField(*DistanceField, ImportOption)) {
+		return nullptr;
 	}
-	else return NewObject<UMaterial>();
+	return DistanceField;
 }
 
-void UVoxelFactory::GetPackagePaths(UObject * fromParentUObject, FString * outAbsPath, FString * outPackagePath) const
+/**
+ * AttachDistanceField
+ * Save voxel distance field with mesh built with bVoxelDistanceField and
+ * replace its empty one. Build settings keep resolution scale 0, so the
+ * field is applied again whenever render data is built or loaded.
+ * @param StaticMesh Mesh built without distance field
+ * @param DistanceField Voxel distance field of mesh
+ */
+void UVoxelFactory::AttachDistanceField(UStaticMesh* StaticMesh, TUniquePtr<FDistanceFieldVolumeData> DistanceField) const
 {
-	FString p = fromParentUObject->GetFName().ToString();
-	*outPackagePath = FPaths::GetPath(p)+"/";
-	p = p.RightChop(6);	
-	*outAbsPath = FPaths::GameContentDir().Append(FPaths::GetPath(p)+"/");
-
+	check(IsInGameThread());
+	UVoxelDistanceFieldUserData* UserData = NewObject<UVoxelDistanceFieldUserData>(StaticMesh, NAME_None, RF_Transactional);
+	UserData->SetDistanceField(*DistanceField);
+	//replaces user data of same class
+	StaticMesh->AddAssetUserData(UserData);
+	UserData->ApplyTo(StaticMesh);
 }
 
-FVoxProjectFile UVoxelFactory::ImportVoxProject(FArchive& Ar)
+/**
+ * CreateSceneBlueprint
+ * Create actor blueprint placing every model instance of the scene graph.
+ * Meshes placed more than once use hierarchical instanced static mesh
+ * component, others use static mesh component.
+ * @param InParent Blueprint package
+ * @param InName Blueprint name
+ * @param Flags Import flags
+ * @param Project Vox project contains scene graph
+ * @param Meshes Static mesh of each model id
+ */
+UBlueprint* UVoxelFactory::CreateSceneBlueprint(UObject* InParent, FName InName, EObjectFlags Flags, const FVoxProjectFile& Project, const TArray<UStaticMesh*>& Meshes) const
 {
-	/** Magic number ( 'V' 'O' 'X' 'space' ) and terminate */
-	ANSICHAR MagicNumber[5];
-	/** version number ( current version is 150 ) */
-	uint32 VersionNumber = 0;
-
-	Ar.Serialize(MagicNumber, 4);
+	TArray<FVoxModelInstance> Instances;
+	Project.scene.GetInstances(Instances);
+	Instances.RemoveAll([&](const FVoxModelInstance& Instance) {
+		return !Meshes.IsValidIndex(Instance.ModelId) || !Meshes[Instance.ModelId];
+	});
+	if (Instances.Num() == 0) {
+		UE_LOG(LogVoxelFactory, Warning, TEXT("No scene graph to import."));
+		return nullptr;
+	}
 
-	FVoxProjectFile info;
-	info.archiveName = GetCurrentFilename();
-	info.versionNumber = VersionNumber;
-	info.valid = true;
+	UBlueprint* Blueprint = FindObject<UBlueprint>(InParent, *InName.ToString());
+	if (Blueprint) {
+		USimpleConstructionScript* SCS = Blueprint->SimpleConstructionScript;
+		for (USCS_Node* Node : SCS->GetAllNodes()) {
+			if (Node != SCS->GetDefaultSceneRootNode()) {
+				SCS->RemoveNode(Node);
+			}
+		}
+	} else {
+		Blueprint = FKismetEditorUtilities::CreateBlueprint(AActor::StaticClass(), InParent, InName, BPTYPE_Normal, UBlueprint::StaticClass(), UBlueprintGeneratedClass::StaticClass());
+		Blueprint->SetFlags(Flags | RF_Public);
+	}
 
-	if (0 != FCStringAnsi::Strncmp("VOX ", MagicNumber, 4)) {
-		UE_LOG(LogVoxelFactory, Error, TEXT("not a vox format"));
-		info.valid = false;
+	TMap<UStaticMesh*, int32> NumInstances;
+	for (const FVoxModelInstance& Instance : Instances) {
+		++NumInstances.FindOrAdd(Meshes[Instance.ModelId]);
 	}
-	UE_LOG(LogVoxelFactory, Verbose, TEXT("MAGIC NUMBER: %s"), &MagicNumber);
 
-	Ar << VersionNumber;
-	UE_LOG(LogVoxelFactory, Display, TEXT("VERSION NUMBER: %d"), VersionNumber);
+	USimpleConstructionScript* SCS = Blueprint->SimpleConstructionScript;
+	const auto AddNode = [SCS](USCS_Node* Node) {
+		if (USCS_Node* RootNode = SCS->GetDefaultSceneRootNode()) {
+			RootNode->AddChildNode(Node);
+		} else {
+			SCS->AddNode(Node);
+		}
+	};
+	TMap<UStaticMesh*, UInstancedStaticMeshComponent*> InstancedComponents;
+	for (const FVoxModelInstance& Instance : Instances) {
+		UStaticMesh* Mesh = Meshes[Instance.ModelId];
+		const FTransform Transform = FVoxScene::ToUnrealTransform(Instance, Project.sizes[Instance.ModelId], ImportOption);
+		if (NumInstances[Mesh] == 1) {
+			USCS_Node* Node = SCS->CreateNode(UStaticMeshComponent::StaticClass(), Mesh->GetFName());
+			UStaticMeshComponent* Component = CastChecked<UStaticMeshComponent>(Node->ComponentTemplate);
+			Component->SetStaticMesh(Mesh);
+			Component->SetRelativeTransform(Transform);
+			AddNode(Node);
+			continue;
+		}
+		UInstancedStaticMeshComponent*& Component = InstancedComponents.FindOrAdd(Mesh);
+		if (!Component) {
+			USCS_Node* Node = SCS->CreateNode(UHierarchicalInstancedStaticMeshComponent::StaticClass(), *FString::Printf(TEXT("%s_Instances"), *Mesh->GetName()));
+			Component = CastChecked<UInstancedStaticMeshComponent>(Node->ComponentTemplate);
+			Component->SetStaticMesh(Mesh);
+			AddNode(Node);
+		}
+		Component->AddInstance(Transform);
+	}
+	FKismetEditorUtilities::CompileBlueprint(Blueprint);
+	return Blueprint;
+}
 
-	if (150 < VersionNumber) {
-		UE_LOG(LogVoxelFactory, Error, TEXT("unsupported version."));
-		info.valid = false;
+/**
+ * GetOptimizedRawMesh
+ * Fetch optimized raw mesh from derived data cache or generate and store it.
+ * Collision is cooked from the raw mesh by UStaticMesh::Build so only the
+ * raw mesh is cached, and only when it was generated and is valid.
+ * @param OutRawMesh Out raw mesh
+ * @param Vox Voxel data
+ * @param SourceHash Hash of voxel data and import options used as cache key
+ */
+void UVoxelFactory::GetOptimizedRawMesh(FRawMesh& OutRawMesh, const FVox* Vox, const FString& SourceHash) const
+{
+	const FString DerivedDataKey = FDerivedDataCacheInterface::BuildCacheKey(TEXT("VOX4U_MESH"), VOX_DERIVEDDATA_VER, *SourceHash);
+	TArray<uint8> DerivedData;
+	if (GetDerivedDataCacheRef().GetSynchronous(*DerivedDataKey, DerivedData)) {
+		FMemoryReader Ar(DerivedData, true);
+		Ar << OutRawMesh;
+		if (!Ar.IsError() && OutRawMesh.IsValidOrFixable()) {
+			UE_LOG(LogVoxelFactory, Verbose, TEXT("Raw mesh found in derived data cache. %s"), *DerivedDataKey);
+			return;
+		}
+		UE_LOG(LogVoxelFactory, Warning, TEXT("Corrupted raw mesh in derived data cache. %s"), *DerivedDataKey);
+		OutRawMesh.Empty();
+		DerivedData.Reset();
 	}
-	if (!info.valid) return info;
 
-	ANSICHAR ChunkId[5] = { 0, };
-	uint32 SizeOfChunkContents;
-	uint32 TotalSizeOfChildrenChunks;
+	if (!Vox->CreateOptimizedRawMesh(OutRawMesh, ImportOption) || !OutRawMesh.IsValidOrFixable()) {
+		UE_LOG(LogVoxelFactory, Warning, TEXT("Failed to generate raw mesh. %s"), *DerivedDataKey);
+		return;
+	}
+	FMemoryWriter Ar(DerivedData, true);
+	Ar << OutRawMesh;
+	GetDerivedDataCacheRef().Put(*DerivedDataKey, DerivedData);
+}
 
-	FIntVector Size;
+/**
+ * CreateMaterial
+ * Create palette texture and material once per distinct palette. Meshes of
+ * same file and files in same folder with identical palette share the
+ * material, default material is used if texture can not be created.
+ * @param InParent Import package
+ * @param InName Object name
+ * @param Flags Import flags
+ * @param Vox Voxel file data
+ */
+UMaterialInterface* UVoxelFactory::CreateMaterial(UObject* InParent, FName& InName, EObjectFlags Flags, const FVox* Vox) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_Material);
+	if (!ImportOption->bImportMaterial) {
+		return UMaterial::GetDefaultMaterial(MD_Surface);
+	}
 
+	//palette sha names assets, so identical palettes find them by path
+	FSHAHash PaletteHash;
+	FSHA1::HashBuffer(Vox->Palette.GetData(), Vox->Palette.Num() * sizeof(FColor), PaletteHash.Hash);
+	const bool bAmbientOcclusion = ImportOption->bBakeAmbientOcclusion;
+	const FString BaseName = TEXT("VoxPalette_") + PaletteHash.ToString();
+	const FString MaterialName = BaseName + (bAmbientOcclusion ? TEXT("_AO_MT") : TEXT("_MT"));
+	const FString TextureName = BaseName + TEXT("_TX");
+
+	//looked up in folder of import, registry knows assets created in memory too
+	FString assetPath, absPath;
+	GetPackagePaths(InParent, &absPath, &assetPath);
+	const FString MaterialPath = assetPath + MaterialName + TEXT(".") + MaterialName;
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	if (UMaterialInterface* Material = Cast<UMaterialInterface>(AssetRegistryModule.Get().GetAssetByObjectPath(*MaterialPath).GetAsset())) {
+		return Material;
+	}
 
-	do {
-		Ar.Serialize(ChunkId, 4);
-		Ar << SizeOfChunkContents;
-		Ar << TotalSizeOfChildrenChunks;
-		if (0 == FCStringAnsi::Strncmp("MAIN", ChunkId, 4)) {
-			//UE_LOG(LogVox, Display, TEXT("MAIN: "));
-		}
-		else if (0 == FCStringAnsi::Strncmp("PACK", ChunkId, 4)) {
-			//apparently this is obsolete and not used when there is scene with multiple models
-			//UE_LOG(LogVox, Display, TEXT("PACK:"));
-			int NumModels;
-			Ar << NumModels;
-			//UE_LOG(LogVox, Display, TEXT("      NumModels %d"), NumModels);
+	//palette texture is shared by material with and without ambient occlusion,
+	//found on disk too so a new one never replaces it
+	const FString TexturePath = assetPath + TextureName + TEXT(".") + TextureName;
+	UTexture2D* Texture = Cast<UTexture2D>(AssetRegistryModule.Get().GetAssetByObjectPath(*TexturePath).GetAsset());
+	if (!Texture) {
+		UPackage* texPackage = CreatePackage(nullptr, *(assetPath + TextureName));
+		Texture = NewObject<UTexture2D>(texPackage, *TextureName, Flags | RF_Public | RF_Standalone);
+		if (!Vox->CreateTexture(Texture, ImportOption)) {
+			UE_LOG(LogVoxelFactory, Warning, TEXT("Failed to create palette texture %s."), *TextureName);
+			Texture->ClearFlags(RF_Public | RF_Standalone);
+			Texture->MarkPendingKill();
+			return UMaterial::GetDefaultMaterial(MD_Surface);
 		}
-		//nTRN = transform Node Chunk : "nTRN". we use it to read scene model name
-		else if (0 == FCStringAnsi::Strncmp("nTRN", ChunkId, 4)) {
-			/*
-			int32	: node id
-			DICT	: node attributes
-				  (_name : string)
-				  (_hidden : 0/1)
-			int32 	: child node id
-			int32 	: reserved id (must be -1)
-			int32	: layer id
-			int32	: num of frames (must be 1)
-
-			// for each frame
-			{
-			DICT	: frame attributes
-				  (_r : int8) ROTATION, see (c)
-				  (_t : int32x3) translation
-			}xN
-			*/
-			int64 posStart = Ar.Tell();
-			int32 nodeId, childId, reserverdId, layerId, frames = -1;
-			Ar << nodeId;
-			//UE_LOG(LogVox, Display, TEXT("transform chunk Id: %d"), nodeId);
-			TMap<FString, FString> attribs = FVox::ReadVoxDictionary(Ar);
-			FString modelName;
-			if (attribs.Num() > 0) {
-				FString chunkIdStr;
-				chunkIdStr.AppendChars(ANSI_TO_TCHAR(ChunkId), 5);//this is not chunk id we are looking for..
-
-				
-				modelName = *attribs.Find("_name");
-				
-			}
-			//add either empty or valid name to list
-			info.names.Add(modelName);
-			//read some more
-			Ar << childId << reserverdId << layerId << frames;
-			//UE_LOG(LogVox, Display, TEXT("childId: %d"), childId);
-			//not really interested in frame attributes but need to read them anyways
-			for (int i = 0; i < frames; i++) {
-				TMap<FString, FString> frameAttrib = FVox::ReadVoxDictionary(Ar);
-			}
-			int64 posEnd = Ar.Tell();
-			int bytesRead = posEnd - posStart;
-			int bytesRemaining = SizeOfChunkContents - bytesRead;
-
-			//debug- consume rest of remaining bytes and don't crash
-			uint8 byte;
-			for (int i = 0; i < bytesRemaining; ++i) {
-				Ar << byte;
-			}
+		Texture->PostEditChange();
+		Texture->MarkPackageDirty();
+		FAssetRegistryModule::AssetCreated(Texture);
+	}
 
+	UPackage* matPackage = CreatePackage(nullptr, *(assetPath + MaterialName));
+	UMaterial* Material = NewObject<UMaterial>(matPackage, *MaterialName, Flags | RF_Public | RF_Standalone);
+	Material->TwoSided = false;
+	Material->SetShadingModel(MSM_DefaultLit);
+	UMaterialExpressionTextureSample* Expression = NewObject<UMaterialExpressionTextureSample>(Material);
+	Material->Expressions.Add(Expression);
+	Material->BaseColor.Expression = Expression;
+	Expression->Texture = Texture;
+	if (bAmbientOcclusion) {
+		UMaterialExpressionVertexColor* VertexColor = NewObject<UMaterialExpressionVertexColor>(Material);
+		Material->Expressions.Add(VertexColor);
+		UMaterialExpressionMultiply* Multiply = NewObject<UMaterialExpressionMultiply>(Material);
+		Material->Expressions.Add(Multiply);
+		Multiply->A.Expression = Expression;
+		Multiply->B.Expression = VertexColor;
+		Multiply->B.OutputIndex = 1;
+		Material->BaseColor.Expression = Multiply;
+	}
+	Material->PostEditChange();
+	Material->MarkPackageDirty();
+	FAssetRegistryModule::AssetCreated(Material);
+	return Material;
+}
+
+void UVoxelFactory::GetPackagePaths(UObject * fromParentUObject, FString * outAbsPath, FString * outPackagePath) const
+{
+	FString p = fromParentUObject->GetFName().ToString();
+	*outPackagePath = FPaths::GetPath(p)+"/";
+	p = p.RightChop(6);	
+	*outAbsPath = FPaths::GameContentDir().Append(FPaths::GetPath(p)+"/");
+
+}
+
+FVoxProjectFile UVoxelFactory::ImportVoxProject(FArchive& Ar)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VoxImport_Parse);
+	FVoxProjectFile info;
+	info.archiveName = GetCurrentFilename();
+	info.versionNumber = 0;
+	info.valid = false;
+
+	VoxCore::VoxFile File;
+	const bool bRead = FVoxCoreAdapter::ReadVox(Ar, File, [&](const VoxCore::VoxChunk& Chunk, FArchive& ChunkAr) {
+		//nTRN = transform Node Chunk : "nTRN". we use it to read scene model name and placement
+		if (Chunk.Is("nTRN")) {
+			const int32 nodeId = info.scene.ReadTransformNode(ChunkAr);
+			//add either empty or valid name to list
+			info.names.Add(info.scene.Nodes[nodeId].Name);
 		}
-		else if (0 == FCStringAnsi::Strncmp("SIZE", ChunkId, 4)) {
-			
-			Ar << Size.X << Size.Y << Size.Z;
-			if (ImportOption->bImportXForward) {
-				int32 temp = Size.X;
-				Size.X = Size.Y;
-				Size.Y = temp;
-			}
-			//UE_LOG(LogVox, Display, TEXT("SIZE: %s"), *Size.ToString());
-			info.sizes.Add(Size);
-		}
-		else if (0 == FCStringAnsi::Strncmp("XYZI", ChunkId, 4)) {
-			uint32 NumVoxels;
-			Ar << NumVoxels;
-			//UE_LOG(LogVox, Display, TEXT("XYZI: NumVoxels=%d"), NumVoxels);
-			uint8 X, Y, Z, I;
-			TMap<FIntVector, uint8> voxel;
-			for (uint32 i = 0; i < NumVoxels; ++i) {
-				Ar << X << Y << Z << I;
-				if (ImportOption->bImportXForward) {
-					uint8 temp = X;
-					X = Size.X - Y - 1;
-					Y = Size.Y - temp - 1;
-				}
-				else {
-					X = Size.X - X - 1;
-				}
-				//UE_LOG(LogVox, Verbose, TEXT("      Voxel X=%d Y=%d Z=%d I=%d"), X, Y, Z, I);
-				//Voxel.Add(FIntVector(X, Y, Z), I);
-				voxel.Add(FIntVector(X, Y, Z), I);
-			}
-			info.voxels.Add(voxel);
-		}
-		else if (0 == FCStringAnsi::Strncmp("RGBA", ChunkId, 4)) {
-			//UE_LOG(LogVox, Verbose, TEXT("RGBA:"));
-			FColor Color;
-			for (uint32 i = 0; i < SizeOfChunkContents / 4; ++i) {
-				Ar << Color.R << Color.G << Color.B << Color.A;
-				//UE_LOG(LogVox, Verbose, TEXT("      %s"), *Color.ToString());
-				info.palette.Add(Color);
-			}
-		}
-		else if (0 == FCStringAnsi::Strncmp("MATT", ChunkId, 4)) {
-			//UE_LOG(LogVox, Warning, TEXT("Unsupported MATT chunk."));
-			//btw: * the MATT chunk is deprecated, replaced by the MATL chunk, see (4)
-			uint8 byte;
-			for (uint32 i = 0; i < SizeOfChunkContents; ++i) {
-				Ar << byte;
-			}
+		//nGRP = group node chunk, nSHP = shape node chunk. scene graph placing models
+		else if (Chunk.Is("nGRP")) {
+			info.scene.ReadGroupNode(ChunkAr);
 		}
-		else {
-			FString UnknownChunk(ChunkId);
-			//UE_LOG(LogVox, Warning, TEXT("Unsupported chunk [ %s ]. Skipping %d byte of chunk contents."), *UnknownChunk, SizeOfChunkContents);
-			uint8 byte;
-			for (uint32 i = 0; i < SizeOfChunkContents; ++i) {
-				Ar << byte;
-			}
+		else if (Chunk.Is("nSHP")) {
+			info.scene.ReadShapeNode(ChunkAr);
 		}
-	} while (!Ar.AtEnd());
+	});
+	if (!bRead) return info;
 
+	info.versionNumber = File.Version;
+	info.valid = true;
+	for (const VoxCore::VoxModel& Model : File.Models) {
+		info.sizes.Add(FVoxCoreAdapter::GetSize(Model, ImportOption));
+		FVoxCoreAdapter::GetCells(Model, ImportOption, info.voxels[info.voxels.AddDefaulted()]);
+	}
+	FVoxCoreAdapter::GetPalette(File, info.palette);
 	return info;
 }
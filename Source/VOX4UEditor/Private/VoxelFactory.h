@@ -7,6 +7,8 @@
 #include <Factories/Factory.h>
 #include <RawMesh.h>
 #include <Vox.h>
+#include "VoxImportStats.h"
+#include "VoxScene.h"
 #include "VoxelFactory.generated.h"
 
 //sotres info about vox archive, model names, ids..
@@ -18,6 +20,8 @@ public:
 	TArray<FColor> palette;
 	TArray<FIntVector> sizes;
 	TArray<TMap<FIntVector, uint8>> voxels;
+	//scene graph placing models
+	FVoxScene scene;
 	//is this vox archive file?
 	bool valid;	
 
@@ -27,6 +31,8 @@ public:
 };
 
 struct FVox;
+class FDistanceFieldVolumeData;
+class UBlueprint;
 class UDestructibleMesh;
 class UMaterialInterface;
 class USkeletalMesh;
@@ -64,13 +70,27 @@ private:
 
 	UStaticMesh* CreateStaticMesh(UObject* InParent, FName InName, EObjectFlags Flags, const FVox* Vox) const;
 
+	UStaticMesh* CreateStaticMesh(UObject* InParent, FName InName, EObjectFlags Flags, const FVox* Vox, FRawMesh& RawMesh, const FString& SourceHash, bool bVoxelDistanceField = false, int32 NumFrames = 0) const;
+
+	UStaticMesh* FindUpToDateStaticMesh(UObject* InParent, FName InName, const FString& SourceHash) const;
+
+	UStaticMesh* CreateAnimation(UObject* InParent, FName InName, EObjectFlags Flags, const FVoxProjectFile& Project) const;
+
 	USkeletalMesh* CreateSkeletalMesh(UObject* InParent, FName InName, EObjectFlags Flags, const FVox* Vox) const;
 
 	UDestructibleMesh* CreateDestructibleMesh(UObject* InParent, FName InName, EObjectFlags Flags, const FVox* Vox) const;
 
 	UVoxel* CreateVoxel(UObject* InParent, FName InName, EObjectFlags Flags, const FVox* Vox) const;
 
-	UStaticMesh* BuildStaticMesh(UStaticMesh* OutStaticMesh, FRawMesh& RawMesh) const;
+	UStaticMesh* BuildStaticMesh(UStaticMesh* OutStaticMesh, FRawMesh& RawMesh, bool bVoxelDistanceField = false) const;
+
+	TUniquePtr<FDistanceFieldVolumeData> CreateDistanceField(const FVox* Vox) const;
+
+	void AttachDistanceField(UStaticMesh* StaticMesh, TUniquePtr<FDistanceFieldVolumeData> DistanceField) const;
+
+	void GetOptimizedRawMesh(FRawMesh& OutRawMesh, const FVox* Vox, const FString& SourceHash) const;
+
+	UBlueprint* CreateSceneBlueprint(UObject* InParent, FName InName, EObjectFlags Flags, const FVoxProjectFile& Project, const TArray<UStaticMesh*>& Meshes) const;
 
 	UMaterialInterface* CreateMaterial(UObject* InParent, FName &InName, EObjectFlags Flags, const FVox* Vox) const;
 	
@@ -84,4 +104,7 @@ protected:
 	UPROPERTY()
 	UVoxImportOption* ImportOption;
 	bool bShowOption;
+
+	/** Timing and geometry summary of current import */
+	mutable FVoxImportStatistics Statistics;
 };
@@ -28,7 +28,9 @@ public class VOX4UEditor : ModuleRules
 			new string[]
 			{
 				"VOX4U",
+				"VoxCore",
 				"CoreUObject",
+				"DerivedDataCache",
 				"Engine",
 				"RawMesh",
 				"Slate",